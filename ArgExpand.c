@@ -0,0 +1,289 @@
+/*
+ * CBUtilLib: Expand response files in a list of command-line arguments
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* History:
+  CJB: 17-Oct-26: Created this source file.
+*/
+
+/* ISO library header files */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <stdint.h>
+#include <ctype.h>
+
+/* My library files */
+#include "ArgUtils.h"
+#include "Internal/CBUtilMisc.h"
+
+enum
+{
+  MinFileBufferSize = 4096,
+  MinArgCapacity = 16,
+};
+
+static bool add_arg(ArgList *const list, const char *const arg)
+{
+  /* Appends an argument, leaving space for a null pointer after it */
+  assert(list != NULL);
+  assert(arg != NULL);
+
+  if (list->argc + 1 >= list->capacity)
+  {
+    if (list->capacity > INT_MAX / 2 ||
+        (size_t)list->capacity * 2 > SIZE_MAX / sizeof(list->argv[0]))
+    {
+      return false;
+    }
+
+    int const capacity = list->capacity > 0 ?
+                         list->capacity * 2 : MinArgCapacity;
+    const char **const argv = realloc(list->argv,
+                                      (size_t)capacity * sizeof(*argv));
+    if (argv == NULL)
+    {
+      return false;
+    }
+
+    list->argv = argv;
+    list->capacity = capacity;
+  }
+
+  list->argv[list->argc++] = arg;
+  list->argv[list->argc] = NULL;
+  return true;
+}
+
+static char *read_file(FILE *const f)
+{
+  /* Reads the whole of a file into a nul-terminated buffer, doubling its
+     size as necessary. */
+  assert(f != NULL);
+
+  char *buffer = NULL;
+  size_t size = 0, len = 0;
+
+  do
+  {
+    if (size - len < 2)
+    {
+      size_t const new_size = size > 0 ? size * 2 : MinFileBufferSize;
+      if (new_size < size)
+      {
+        free(buffer);
+        return NULL;
+      }
+
+      char *const new_buffer = realloc(buffer, new_size);
+      if (new_buffer == NULL)
+      {
+        free(buffer);
+        return NULL;
+      }
+      buffer = new_buffer;
+      size = new_size;
+    }
+
+    len += fread(buffer + len, 1, size - len - 1, f);
+  }
+  while (!feof(f) && !ferror(f));
+
+  if (ferror(f))
+  {
+    free(buffer);
+    return NULL;
+  }
+
+  buffer[len] = '\0';
+  DEBUGF("Read %zu bytes into buffer %p\n", len, (void *)buffer);
+  return buffer;
+}
+
+static bool split_args(ArgList *const list, char *const buffer,
+                       const char *const filename)
+{
+  /* Splits the contents of a response file into arguments in place.
+     Characters are moved towards the start of the buffer to remove quotes
+     and backslashes, so each argument is terminated where it ends. */
+  assert(list != NULL);
+  assert(buffer != NULL);
+  assert(filename != NULL);
+
+  char *in = buffer, *out = buffer;
+
+  for (;;)
+  {
+    while (isspace((unsigned char)*in))
+    {
+      ++in;
+    }
+
+    if (*in == '\0')
+    {
+      return true;
+    }
+
+    char *const arg = out;
+    char quote = '\0';
+
+    for (; *in != '\0'; ++in)
+    {
+      if (*in == '\\' && in[1] != '\0')
+      {
+        *out++ = *++in;
+      }
+      else if (quote != '\0')
+      {
+        if (*in == quote)
+        {
+          quote = '\0';
+        }
+        else
+        {
+          *out++ = *in;
+        }
+      }
+      else if (*in == '"' || *in == '\'')
+      {
+        quote = *in;
+      }
+      else if (isspace((unsigned char)*in))
+      {
+        break;
+      }
+      else
+      {
+        *out++ = *in;
+      }
+    }
+
+    if (quote != '\0')
+    {
+      fprintf(stderr, "Unterminated quote in %s\n", filename);
+      return false;
+    }
+
+    /* The terminator may overwrite the separator that ended the argument
+       but never a character that has yet to be read. */
+    if (*in != '\0')
+    {
+      ++in;
+    }
+    *out++ = '\0';
+
+    DEBUG_VERBOSEF("Argument '%s' from %s\n", arg, filename);
+    if (!add_arg(list, arg))
+    {
+      return false;
+    }
+  }
+}
+
+static bool expand_file(ArgList *const list, const char *const filename)
+{
+  /* Appends the arguments read from a given response file */
+  assert(list != NULL);
+  assert(filename != NULL);
+  DEBUGF("Expanding response file %s\n", filename);
+
+  char **const buffers = realloc(list->buffers,
+                                 (list->nbuffers + 1) * sizeof(*buffers));
+  if (buffers == NULL)
+  {
+    return false;
+  }
+  list->buffers = buffers;
+
+  FILE *const f = fopen(filename, "rb");
+  if (f == NULL)
+  {
+    fprintf(stderr, "Can't open %s\n", filename);
+    return false;
+  }
+
+  char *const buffer = read_file(f);
+  fclose(f);
+  if (buffer == NULL)
+  {
+    fprintf(stderr, "Can't read %s\n", filename);
+    return false;
+  }
+
+  list->buffers[list->nbuffers++] = buffer;
+  return split_args(list, buffer, filename);
+}
+
+/* ----------------------------------------------------------------------- */
+/*                         Public functions                                */
+
+bool arg_list_expand(ArgList *const list, int const argc,
+                     const char *const argv[])
+{
+  assert(list != NULL);
+  assert(argc >= 0);
+  assert(argv != NULL || argc == 0);
+
+  *list = (ArgList){.argc = 0, .argv = NULL, .capacity = 0,
+                    .buffers = NULL, .nbuffers = 0};
+
+  /* Allocate the array of arguments even if it will be empty */
+  bool success = add_arg(list, "");
+  list->argc = 0;
+
+  for (int i = 0; success && i < argc; ++i)
+  {
+    assert(argv[i] != NULL);
+    if (argv[i][0] == '@' && argv[i][1] != '\0')
+    {
+      success = expand_file(list, argv[i] + 1);
+    }
+    else
+    {
+      success = add_arg(list, argv[i]);
+    }
+  }
+
+  if (!success)
+  {
+    arg_list_destroy(list);
+    return false;
+  }
+
+  list->argv[list->argc] = NULL;
+
+  DEBUGF("Expanded %d arguments to %d\n", argc, list->argc);
+  return true;
+}
+
+/* ----------------------------------------------------------------------- */
+
+void arg_list_destroy(ArgList *const list)
+{
+  assert(list != NULL);
+  DEBUGF("Destroying argument list %p\n", (void *)list);
+
+  for (size_t i = 0; i < list->nbuffers; ++i)
+  {
+    free(list->buffers[i]);
+  }
+  free(list->buffers);
+  free(list->argv);
+}
@@ -0,0 +1,241 @@
+/*
+ * CBUtilLib: Table-driven parser for command-line options
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* History:
+  CJB: 17-Oct-26: Created this source file.
+*/
+
+/* ISO library header files */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/* My library files */
+#include "ArgUtils.h"
+#include "Internal/CBUtilMisc.h"
+
+/* Options are indexed by sorting their names. All of the names that begin
+   with a given argument are then adjacent, starting at the first name not
+   less than the argument, so candidates for an abbreviation can be found
+   by binary search. */
+
+struct ArgParser
+{
+  size_t noptions;
+  const ArgOption *sorted[];
+};
+
+static int compare_options(const void *const a, const void *const b)
+{
+  const ArgOption *const *const option_a = a;
+  const ArgOption *const *const option_b = b;
+  return strcmp((*option_a)->name, (*option_b)->name);
+}
+
+static const ArgOption *find_option(const ArgParser *const parser,
+                                    const char *const arg)
+{
+  /* Finds the option matching a given argument. Returns NULL (having
+     printed a message) if there is no match or more than one match. */
+  assert(parser != NULL);
+  assert(arg != NULL);
+
+  size_t low = 0, high = parser->noptions;
+  while (low < high)
+  {
+    size_t const mid = low + (high - low) / 2;
+    if (strcmp(parser->sorted[mid]->name, arg) < 0)
+    {
+      low = mid + 1;
+    }
+    else
+    {
+      high = mid;
+    }
+  }
+
+  size_t const arg_len = strlen(arg);
+  const ArgOption *match = NULL;
+  size_t nmatches = 0;
+
+  for (size_t i = low; i < parser->noptions; ++i)
+  {
+    const ArgOption *const option = parser->sorted[i];
+    if (strncmp(option->name, arg, arg_len) != 0)
+    {
+      break; /* no more names begin with the argument */
+    }
+
+    if (option->name[arg_len] == '\0')
+    {
+      /* An exact match is sorted first and can't be ambiguous */
+      DEBUGF("Argument '%s' is option '%s'\n", arg, option->name);
+      return option;
+    }
+
+    if (arg_len >= option->min)
+    {
+      match = option;
+      ++nmatches;
+    }
+  }
+
+  if (nmatches == 0)
+  {
+    fprintf(stderr, "Unknown switch %s\n", arg);
+    return NULL;
+  }
+
+  if (nmatches > 1)
+  {
+    fprintf(stderr, "Ambiguous switch %s\n", arg);
+    return NULL;
+  }
+
+  DEBUGF("Argument '%s' is an abbreviation of option '%s'\n", arg,
+         match->name);
+  return match;
+}
+
+/* ----------------------------------------------------------------------- */
+/*                         Public functions                                */
+
+ArgParser *arg_parser_make(const ArgOption *const options,
+                           size_t const noptions)
+{
+  assert(options != NULL || noptions == 0);
+  DEBUGF("Making parser for %zu options\n", noptions);
+
+  if (noptions > (SIZE_MAX - sizeof(ArgParser)) / sizeof(ArgOption *))
+  {
+    return NULL;
+  }
+
+  ArgParser *const parser = malloc(sizeof(*parser) +
+                                   noptions * sizeof(parser->sorted[0]));
+  if (parser == NULL)
+  {
+    return NULL;
+  }
+
+  parser->noptions = noptions;
+  for (size_t i = 0; i < noptions; ++i)
+  {
+    assert(options[i].name != NULL);
+    assert(options[i].min > 0);
+    assert(options[i].value != NULL);
+    parser->sorted[i] = &options[i];
+  }
+
+  qsort(parser->sorted, noptions, sizeof(parser->sorted[0]),
+        compare_options);
+
+#ifndef NDEBUG
+  for (size_t i = 1; i < noptions; ++i)
+  {
+    assert(strcmp(parser->sorted[i - 1]->name, parser->sorted[i]->name) != 0);
+  }
+#endif
+
+  return parser;
+}
+
+/* ----------------------------------------------------------------------- */
+
+void arg_parser_destroy(ArgParser *const parser)
+{
+  DEBUGF("Destroying parser %p\n", (void *)parser);
+  free(parser);
+}
+
+/* ----------------------------------------------------------------------- */
+
+bool arg_parser_parse(const ArgParser *const parser, int const argc,
+                      const char *const argv[], int *const n)
+{
+  assert(parser != NULL);
+  assert(argc > 0);
+  assert(argv != NULL);
+  assert(n != NULL);
+  assert(*n >= 0);
+
+  int i = *n;
+  for (; i < argc && argv[i][0] == '-'; ++i)
+  {
+    if (strcmp(argv[i], "--") == 0)
+    {
+      ++i;
+      break;
+    }
+
+    const ArgOption *const option = find_option(parser, argv[i]);
+    if (option == NULL)
+    {
+      *n = i;
+      return false;
+    }
+
+    bool success = true;
+    switch (option->type)
+    {
+      case ArgOptionType_Switch:
+        {
+          bool *const value = option->value;
+          *value = true;
+        }
+        break;
+
+      case ArgOptionType_Long:
+        success = get_long_arg(option->name, option->value,
+                               option->long_min, option->long_max,
+                               argc, argv, ++i);
+        break;
+
+      case ArgOptionType_Double:
+        success = get_double_arg(option->name, option->value,
+                                 option->double_min, option->double_max,
+                                 argc, argv, ++i);
+        break;
+
+      case ArgOptionType_String:
+        if (++i >= argc)
+        {
+          fprintf(stderr, "Missing value for %s\n", option->name);
+          success = false;
+        }
+        else
+        {
+          const char **const value = option->value;
+          *value = argv[i];
+        }
+        break;
+    }
+
+    if (!success)
+    {
+      *n = i;
+      return false;
+    }
+  }
+
+  *n = i;
+  return true;
+}
@@ -23,6 +23,8 @@ Message tokens: None.
 History:
   CJB: 07-Aug-18: Copied this source file from SF3KtoObj.
   CJB: 11-Dec-20: Removed redundant uses of the 'extern' keyword.
+  CJB: 17-Oct-26: Added a table-driven parser for command-line options.
+                  Added a function to expand response files.
 */
 
 #ifndef ArgUtils_h
@@ -41,4 +43,108 @@ bool get_double_arg(const char *name, double *value,
 
 bool is_switch(const char *arg, const char *name, size_t min);
 
+typedef enum
+{
+  ArgOptionType_Switch, /* Sets a bool to true */
+  ArgOptionType_Long,   /* Reads a long int from the next argument */
+  ArgOptionType_Double, /* Reads a double from the next argument */
+  ArgOptionType_String  /* Reads a string from the next argument */
+}
+ArgOptionType;
+
+typedef struct
+{
+  const char    *name;       /* Canonical name of the option, including any
+                                leading '-', as for is_switch. */
+  size_t         min;        /* Minimum length of an abbreviated name. */
+  ArgOptionType  type;       /* Type of the option. */
+  void          *value;      /* Where to store the value, which must be of a
+                                type appropriate to the option: bool,
+                                long int, double or const char *. */
+  long int       long_min;   /* Range of values for an ArgOptionType_Long */
+  long int       long_max;   /* option. */
+  double         double_min; /* Range of values for an ArgOptionType_Double */
+  double         double_max; /* option. */
+}
+ArgOption;
+   /*
+    * Describes one command-line option understood by a parser.
+    */
+
+typedef struct ArgParser ArgParser;
+
+ArgParser *arg_parser_make(const ArgOption * /*options*/, size_t /*noptions*/);
+   /*
+    * Creates a parser for the 'noptions' command-line options described by
+    * the 'options' array, which must remain valid for as long as the
+    * parser is used. Option names are indexed so that each argument can be
+    * looked up quickly instead of being compared with every option name.
+    * No two options may have the same name.
+    * Returns: On successful completion, pointer to a parser, otherwise null
+    *          (eg. when not enough space).
+    */
+
+void arg_parser_destroy(ArgParser * /*parser*/);
+   /*
+    * Frees memory that was previously allocated for a parser.
+    */
+
+bool arg_parser_parse(const ArgParser * /*parser*/, int /*argc*/,
+                      const char *const /*argv*/[], int * /*n*/);
+   /*
+    * Parses options from an array of 'argc' command-line arguments in a
+    * single pass, starting from the argument with index '*n'. Each
+    * argument beginning with '-' is matched against the option names,
+    * allowing any abbreviation no shorter than the option's minimum
+    * length; an exact match takes precedence over abbreviations. Values
+    * are read and checked using get_long_arg or get_double_arg, and stored
+    * in the locations given by the option descriptions. Parsing stops at
+    * the first argument that doesn't begin with '-' or after an argument
+    * that is exactly "--". The index of the next argument is stored in
+    * '*n'. Messages about unknown or ambiguous options and bad values are
+    * printed to stderr.
+    * Returns: true if successful, otherwise false.
+    */
+
+typedef struct
+{
+  int          argc;     /* Number of arguments. */
+  const char **argv;     /* Array of arguments, followed by a null
+                            pointer. */
+  int          capacity; /* Number of elements allocated for 'argv'. */
+  char       **buffers;  /* Contents of each response file. */
+  size_t       nbuffers; /* Number of response files read. */
+}
+ArgList;
+   /*
+    * List of command-line arguments produced by expanding response files
+    * (storage lifetime is under client's control, but the members are
+    * private except for 'argc' and 'argv').
+    */
+
+bool arg_list_expand(ArgList * /*list*/, int /*argc*/,
+                     const char *const /*argv*/[]);
+   /*
+    * Initializes a given list with a copy of an array of 'argc' command-line
+    * arguments, except that each argument of the form '@file' is replaced
+    * with the arguments read from the named file. Arguments in a file are
+    * separated by white-space and may be enclosed in single or double
+    * quotes to include white-space; a backslash includes the following
+    * character literally. Each file is read into memory in one piece and
+    * split into arguments in place, without copying them individually.
+    * Arguments read from a file are not themselves expanded. The resulting
+    * 'argc' and 'argv' members of the list can be used in place of those
+    * passed to main(), e.g. by arg_parser_parse or get_long_arg. Messages
+    * about files that can't be read are printed to stderr.
+    * Returns: true if successful, otherwise false (in which case the list
+    *          need not be destroyed).
+    */
+
+void arg_list_destroy(ArgList * /*list*/);
+   /*
+    * Frees memory that was allocated for a list of command-line arguments,
+    * including the contents of any response files. Pointers to arguments
+    * read from those files become invalid.
+    */
+
 #endif /* ArgUtils_h */
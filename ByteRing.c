@@ -0,0 +1,361 @@
+/*
+ * CBUtilLib: Single-producer, single-consumer ring buffer of bytes
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* History:
+  CJB: 17-Oct-26: Created this source file.
+                  Limit the space reserved for appending to 'max_append'
+                  so that formatted strings don't fit only at some
+                  positions.
+*/
+
+/* ISO library headers */
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdio.h>
+
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && \
+    !defined(__STDC_NO_ATOMICS__)
+#define HAVE_ATOMICS
+#include <stdatomic.h>
+#endif
+
+/* Local headers */
+#include "ByteRing.h"
+#include "Internal/CBUtilMisc.h"
+
+/* The producer's and consumer's indices increase without limit (until
+   they wrap around at SIZE_MAX) and are reduced modulo the capacity only
+   when used to address the buffer. The number of bytes in the ring is
+   the difference between the two indices. Each thread also keeps a copy
+   of the other thread's index, which it only reloads when the copy
+   suggests that there might not be enough space (for the biggest
+   possible append) or data.
+
+   Space for 'max_append' bytes follows the end of the ring so that any
+   reservation is contiguous. When finishing an append, any bytes written
+   beyond the end of the ring are copied to the start. */
+
+enum
+{
+  CacheLineSize = 64, /* Keep the producer's and consumer's indices apart
+                         to avoid false sharing */
+};
+
+#ifdef HAVE_ATOMICS
+typedef atomic_size_t Index;
+#else
+typedef size_t Index;
+#endif
+
+struct ByteRing
+{
+  size_t  capacity;     /* Power of two */
+  size_t  max_append;
+  char   *buffer;       /* 'capacity' + 'max_append' bytes */
+  char    pad1[CacheLineSize];
+
+  /* Written by the producer */
+  Index   write_index;
+  size_t  read_index_copy;
+  size_t  reserved;     /* Size of the space reserved for appending */
+  char    pad2[CacheLineSize];
+
+  /* Written by the consumer */
+  Index   read_index;
+  size_t  write_index_copy;
+};
+
+static inline size_t load_index(Index *const index)
+{
+#ifdef HAVE_ATOMICS
+  return atomic_load_explicit(index, memory_order_acquire);
+#else
+  return *index;
+#endif
+}
+
+static inline void store_index(Index *const index, size_t const value)
+{
+#ifdef HAVE_ATOMICS
+  atomic_store_explicit(index, value, memory_order_release);
+#else
+  *index = value;
+#endif
+}
+
+static inline size_t load_own_index(Index *const index)
+{
+  /* No other thread writes the index, so no ordering is needed. */
+#ifdef HAVE_ATOMICS
+  return atomic_load_explicit(index, memory_order_relaxed);
+#else
+  return *index;
+#endif
+}
+
+static size_t get_free_space(ByteRing *const ring, size_t const write_index)
+{
+  /* Don't report less space than could be reserved unless it is true. */
+  assert(ring != NULL);
+  size_t free_space = ring->capacity -
+                      (write_index - ring->read_index_copy);
+
+  if (free_space < ring->max_append)
+  {
+    ring->read_index_copy = load_index(&ring->read_index);
+    free_space = ring->capacity - (write_index - ring->read_index_copy);
+  }
+
+  assert(free_space <= ring->capacity);
+  return free_space;
+}
+
+/* ----------------------------------------------------------------------- */
+/*                         Public functions                                */
+
+ByteRing *bytering_make(size_t const capacity, size_t const max_append)
+{
+  DEBUGF("ByteRing: Making a ring of %zu bytes (max. append %zu)\n",
+         capacity, max_append);
+
+  size_t size = 1;
+  while (size < capacity)
+  {
+    if (size > SIZE_MAX / 2)
+    {
+      return NULL;
+    }
+    size *= 2;
+  }
+
+  assert(max_append <= size);
+  if (max_append > size || size > SIZE_MAX - max_append)
+  {
+    return NULL;
+  }
+
+  ByteRing *const ring = malloc(sizeof(*ring));
+  if (ring == NULL)
+  {
+    return NULL;
+  }
+
+  ring->buffer = malloc(size + max_append);
+  if (ring->buffer == NULL)
+  {
+    free(ring);
+    return NULL;
+  }
+
+  ring->capacity = size;
+  ring->max_append = max_append;
+  ring->read_index_copy = 0;
+  ring->reserved = 0;
+  ring->write_index_copy = 0;
+#ifdef HAVE_ATOMICS
+  atomic_init(&ring->write_index, 0);
+  atomic_init(&ring->read_index, 0);
+#else
+  ring->write_index = 0;
+  ring->read_index = 0;
+#endif
+
+  DEBUGF("ByteRing: Ring %p has %zu bytes\n", (void *)ring, size);
+  return ring;
+}
+
+/* ----------------------------------------------------------------------- */
+
+void bytering_destroy(ByteRing *const ring)
+{
+  DEBUGF("ByteRing: Destroying ring %p\n", (void *)ring);
+  if (ring != NULL)
+  {
+    free(ring->buffer);
+    free(ring);
+  }
+}
+
+/* ----------------------------------------------------------------------- */
+
+char *bytering_prepare_append(ByteRing *const ring, size_t *const min_size)
+{
+  assert(ring != NULL);
+  assert(min_size != NULL);
+
+  if (*min_size > ring->max_append)
+  {
+    DEBUGF("ByteRing: %zu bytes is too big to append\n", *min_size);
+    return NULL;
+  }
+
+  size_t const write_index = load_own_index(&ring->write_index);
+  size_t const free_space = get_free_space(ring, write_index);
+  if (free_space < *min_size)
+  {
+    DEBUG_VERBOSEF("ByteRing: Only %zu bytes free\n", free_space);
+    return NULL;
+  }
+
+  size_t const pos = write_index & (ring->capacity - 1);
+  size_t const contiguous = ring->capacity - pos + ring->max_append;
+  ring->reserved = LOWEST(LOWEST(free_space, contiguous), ring->max_append);
+  *min_size = ring->reserved;
+
+  return ring->buffer + pos;
+}
+
+/* ----------------------------------------------------------------------- */
+
+void bytering_finish_append(ByteRing *const ring, size_t const n)
+{
+  assert(ring != NULL);
+  assert(n <= ring->reserved);
+
+  size_t const write_index = load_own_index(&ring->write_index);
+  size_t const pos = write_index & (ring->capacity - 1);
+
+  /* Move any bytes that overhang the end of the ring to the start. Their
+     destination is free because it was included in the reservation. */
+  if (n > ring->capacity - pos)
+  {
+    size_t const overhang = n - (ring->capacity - pos);
+    memcpy(ring->buffer, ring->buffer + ring->capacity, overhang);
+  }
+
+  ring->reserved = 0;
+  store_index(&ring->write_index, write_index + n);
+}
+
+/* ----------------------------------------------------------------------- */
+
+bool bytering_append(ByteRing *const ring, const char *const data,
+                     size_t const n)
+{
+  assert(ring != NULL);
+  assert(data != NULL || n == 0);
+
+  size_t min_size = n;
+  char *const free_ptr = bytering_prepare_append(ring, &min_size);
+  if (free_ptr == NULL)
+  {
+    return false;
+  }
+
+  if (n > 0)
+  {
+    memcpy(free_ptr, data, n);
+  }
+  bytering_finish_append(ring, n);
+  return true;
+}
+
+/* ----------------------------------------------------------------------- */
+
+bool bytering_vprintf(ByteRing *const ring, const char *const format,
+                      va_list args)
+{
+  assert(ring != NULL);
+  assert(format != NULL);
+
+  /* Format the string straight into all of the contiguous free space,
+     rather than finding its length first. */
+  size_t min_size = 1;
+  char *const free_ptr = bytering_prepare_append(ring, &min_size);
+  if (free_ptr == NULL)
+  {
+    return false;
+  }
+
+  int const n = vsnprintf(free_ptr, min_size, format, args);
+  if (n < 0 || (unsigned)n >= min_size)
+  {
+    DEBUG_VERBOSEF("ByteRing: Formatted string doesn't fit in %zu bytes\n",
+                   min_size);
+    bytering_finish_append(ring, 0);
+    return false;
+  }
+
+  bytering_finish_append(ring, (unsigned)n);
+  return true;
+}
+
+/* ----------------------------------------------------------------------- */
+
+size_t bytering_get_data(ByteRing *const ring, const char **const data)
+{
+  assert(ring != NULL);
+  assert(data != NULL);
+
+  size_t const read_index = load_own_index(&ring->read_index);
+  if (ring->write_index_copy == read_index)
+  {
+    ring->write_index_copy = load_index(&ring->write_index);
+  }
+
+  size_t const count = ring->write_index_copy - read_index;
+  assert(count <= ring->capacity);
+
+  size_t const pos = read_index & (ring->capacity - 1);
+  *data = ring->buffer + pos;
+  return LOWEST(count, ring->capacity - pos);
+}
+
+/* ----------------------------------------------------------------------- */
+
+void bytering_consume(ByteRing *const ring, size_t const n)
+{
+  assert(ring != NULL);
+
+  size_t const read_index = load_own_index(&ring->read_index);
+  assert(n <= ring->write_index_copy - read_index);
+  store_index(&ring->read_index, read_index + n);
+}
+
+/* ----------------------------------------------------------------------- */
+
+bool bytering_fwrite(ByteRing *const ring, FILE *const f)
+{
+  assert(ring != NULL);
+  assert(f != NULL);
+
+  size_t const read_index = load_own_index(&ring->read_index);
+  ring->write_index_copy = load_index(&ring->write_index);
+  size_t const count = ring->write_index_copy - read_index;
+  assert(count <= ring->capacity);
+
+  /* Write the data before and after the end of the ring (if it wraps
+     around) then consume it all at once. */
+  size_t const pos = read_index & (ring->capacity - 1);
+  size_t const first = LOWEST(count, ring->capacity - pos);
+
+  size_t written = fwrite(ring->buffer + pos, 1, first, f);
+  if (written == first && count > first)
+  {
+    written += fwrite(ring->buffer, 1, count - first, f);
+  }
+  DEBUG_VERBOSEF("ByteRing: Wrote %zu of %zu bytes\n", written, count);
+
+  store_index(&ring->read_index, read_index + written);
+  return written == count;
+}
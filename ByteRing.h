@@ -0,0 +1,157 @@
+/*
+ * CBUtilLib: Single-producer, single-consumer ring buffer of bytes
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* ByteRing.h declares functions to pass a stream of bytes from one
+   thread (the producer) to another (the consumer) through a fixed-size
+   ring buffer, without locking and without allocating memory after the
+   ring has been created. The producer can format strings directly into
+   the ring, in the same way as into a StringBuffer; the consumer can
+   write everything that is in the ring to a file in one batch.
+
+   The ring is only safe to share between two threads if the library was
+   compiled with an ISO C11 compiler that supports the optional
+   <stdatomic.h> header. Otherwise, the producer and consumer must be the
+   same thread.
+
+Dependencies: ANSI C library, ISO C11 atomics (optional).
+Message tokens: None
+History:
+  CJB: 17-Oct-26: Created this header file.
+                  Space reserved for appending is now limited to the
+                  maximum specified when the ring was created.
+*/
+
+#ifndef ByteRing_h
+#define ByteRing_h
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <stdio.h>
+
+typedef struct ByteRing ByteRing;
+
+ByteRing *bytering_make(size_t /*capacity*/, size_t /*max_append*/);
+   /*
+    * Creates a ring buffer that can hold at least 'capacity' bytes.
+    * The capacity is rounded up to a power of two. 'max_append' is the
+    * maximum number of bytes (including any nul terminator) that can be
+    * reserved by a single call to bytering_prepare_append; it must not be
+    * greater than the capacity. Extra memory is allocated so that that
+    * many bytes are always contiguous, even at the end of the ring.
+    * Returns: On successful completion, pointer to a ring buffer,
+    *          otherwise null (eg. when not enough space).
+    */
+
+void bytering_destroy(ByteRing * /*ring*/);
+   /*
+    * Frees the memory that was allocated for a ring buffer. Any data that
+    * has not been consumed is lost. Does nothing if 'ring' is null.
+    */
+
+/* Functions to be called only by the producer: */
+
+char *bytering_prepare_append(ByteRing * /*ring*/, size_t * /*min_size*/);
+   /*
+    * Prepares to append data to a ring buffer by reserving space for at
+    * least 'min_size' bytes (which must include space for a nul
+    * terminator, if written). If successful then 'min_size' may be
+    * increased to reflect the actual amount of contiguous space available
+    * at the returned address, which is never more than the maximum
+    * specified when the ring was created.
+    * Returns: pointer to the place at which to write data, or a null
+    *          pointer if not enough space is free or 'min_size' is greater
+    *          than the maximum specified when the ring was created.
+    */
+
+void bytering_finish_append(ByteRing * /*ring*/, size_t /*n*/);
+   /*
+    * Finishes appending 'n' bytes (not including any nul terminator)
+    * to a ring buffer at the address returned by the previous call to
+    * bytering_prepare_append, making them available to the consumer.
+    * 'n' must be less than or equal to the size of the reserved space.
+    */
+
+bool bytering_append(ByteRing * /*ring*/, const char * /*data*/,
+                     size_t /*n*/);
+   /*
+    * Appends 'n' bytes from 'data' to a ring buffer. No nul terminator is
+    * appended. If 'n' is 0 then 'data' can be a null pointer.
+    * Returns: true if successful, or false if not enough space was free
+    *          or 'n' is greater than the maximum specified when the ring
+    *          was created.
+    */
+
+bool bytering_vprintf(ByteRing * /*ring*/, const char * /*format*/,
+                      va_list /*args*/);
+   /*
+    * Appends a string formatted according to 'format' with parameter
+    * substitution from 'args' to a ring buffer. The string is formatted in
+    * place, so no nul terminator is appended. On failure, no bytes are
+    * appended.
+    * Returns: true if successful, or false if not enough space was free
+    *          or the formatted string (with a nul terminator) would be
+    *          longer than the maximum specified when the ring was created.
+    */
+
+static inline bool bytering_printf(ByteRing *const ring,
+                                   const char *const format,
+                                   ...)
+{
+  va_list args;
+  va_start(args, format);
+  bool const success = bytering_vprintf(ring, format, args);
+  va_end(args);
+  return success;
+}
+   /*
+    * Like bytering_vprintf except that it takes a variable number of
+    * arguments to be substituted into the appended string.
+    * Returns: true if successful, or false if not enough space was free
+    *          or the formatted string (with a nul terminator) would be
+    *          longer than the maximum specified when the ring was created.
+    */
+
+/* Functions to be called only by the consumer: */
+
+size_t bytering_get_data(ByteRing * /*ring*/, const char ** /*data*/);
+   /*
+    * Gets the address of the oldest bytes in a ring buffer that have not
+    * been consumed. Data that wraps around the end of the ring is split
+    * into two parts.
+    * Returns: the number of contiguous bytes at '*data', or 0 if the ring
+    *          is empty (in which case '*data' is indeterminate).
+    */
+
+void bytering_consume(ByteRing * /*ring*/, size_t /*n*/);
+   /*
+    * Frees the oldest 'n' bytes in a ring buffer for reuse by the
+    * producer. 'n' must be less than or equal to the number of bytes in
+    * the ring.
+    */
+
+bool bytering_fwrite(ByteRing * /*ring*/, FILE * /*f*/);
+   /*
+    * Writes all bytes in a ring buffer (that were appended before this
+    * function was called) to the given stream, using at most two calls to
+    * fwrite, and consumes those that were written.
+    * Returns: true if successful, otherwise false (write error).
+    */
+
+#endif
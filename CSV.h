@@ -32,6 +32,15 @@ History:
   CJB: 08-Oct-23: Added type-safe veneer functions, e.g. csv_parse_as_int.
                   Use strtol and strtod instead of atoi, atof and atod to
                   avoid undefined behaviour if the value is unrepresentable.
+  CJB: 17-Oct-26: Added a reader type to split records into fields without
+                  copying them, including quoted fields, and to parse records
+                  with a different type for each field.
+                  Added functions to write records.
+                  Added a strict parse mode that reports invalid values.
+                  Added a function to count records and fields.
+                  Added a format type to specify the separator, decimal
+                  point and comment character used by a reader or scan.
+                  Doubles are written with '.' as the decimal point.
 */
 
 #ifndef CSV_h
@@ -39,6 +48,12 @@ History:
 
 /* ISO library headers */
 #include <stddef.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <stdio.h>
+
+/* Local headers */
+#include "StringBuff.h"
 
 typedef enum
 {
@@ -84,6 +99,286 @@ static inline size_t csv_parse_as_double(const char *const s, char **const endp,
   return csv_parse_string(s, endp, output, CSVOutputType_Double, nmemb);
 }
 
+typedef struct
+{
+  const char *start;   /* Pointer to the first character of the field,
+                          excluding any opening quote. Not terminated. */
+  size_t      len;     /* Number of characters in the field, excluding any
+                          quotes around it. */
+  bool        quoted;  /* True if the field was enclosed in quotes. */
+  bool        escaped; /* True if the field contains pairs of quotes that
+                          each represent a single quote character. */
+}
+CSVField;
+   /*
+    * View of a field in a record. The characters are not copied, so the
+    * view is only valid for as long as the input string.
+    */
+
+typedef enum
+{
+  CSVFieldType_Int,
+  CSVFieldType_Long,
+  CSVFieldType_Double,
+  CSVFieldType_String
+}
+CSVFieldType;
+
+typedef union
+{
+  int      as_int;
+  long int as_long;
+  double   as_double;
+  CSVField as_string;
+}
+CSVValue;
+   /*
+    * Value of a field in a record, interpreted according to the
+    * CSVFieldType specified for that field.
+    */
+
+typedef struct
+{
+  char separator;     /* Character that separates fields, e.g. ',' or
+                         '\t'. Must not be a quote or nul. */
+  char decimal_point; /* Character that separates the whole and fractional
+                         parts of a number, e.g. '.' or ','. */
+  char comment;       /* Character that marks a record to be ignored, if it
+                         is the first character. '\0' for none. */
+}
+CSVFormat;
+   /*
+    * Specifies a variant of the comma-separated value format, e.g. for
+    * tab-separated values or the semicolon-separated values with decimal
+    * commas that are common in Europe.
+    */
+
+static inline CSVFormat csv_format_default(void)
+{
+  return (CSVFormat){.separator = ',', .decimal_point = '.', .comment = '\0'};
+}
+   /*
+    * Gets the standard comma-separated value format.
+    * Returns: a format with ',' as separator, '.' as decimal point and no
+    *          comment character.
+    */
+
+typedef struct
+{
+  const char *input;  /* Pointer to the start of the input string. */
+  const char *next;   /* Pointer to the start of the next record, or NULL
+                         if the end of the input string has been reached. */
+  size_t      record; /* Number of records read so far. */
+  CSVFormat   format; /* Variant of the format to be read. */
+}
+CSVReader;
+   /*
+    * Control structure for reading records from a string in comma-separated
+    * value format (storage lifetime is under client's control). Fields may
+    * be enclosed in double quotes, in which case they may contain commas,
+    * line endings and pairs of quotes that each represent one quote
+    * character (as per RFC 4180). Line endings are recognised as for
+    * csv_parse_string.
+    */
+
+void csv_reader_init(CSVReader * /*reader*/, const char * /*s*/);
+   /*
+    * Initializes a given reader to read records from the string 's', which
+    * must remain valid for as long as the reader and any field views
+    * obtained from it are used.
+    */
+
+void csv_reader_init_format(CSVReader * /*reader*/, const char * /*s*/,
+                            const CSVFormat * /*format*/);
+   /*
+    * Like csv_reader_init except that the records are read in a given
+    * format, or the default format if 'format' is a null pointer. Lines
+    * that begin with the comment character are skipped and are not
+    * counted as records. Faster code is used for ',', '\t' and ';'
+    * separators than for other separators.
+    */
+
+static inline bool csv_reader_at_end(const CSVReader *const reader)
+{
+  assert(reader != NULL);
+  return reader->next == NULL;
+}
+   /*
+    * Finds whether a given reader has reached the end of its input string.
+    * Returns: true if there are no more records to be read.
+    */
+
+size_t csv_reader_split(CSVReader * /*reader*/, CSVField * /*fields*/,
+                        size_t /*nmemb*/);
+   /*
+    * Reads the next record from a given reader and stores a view of each
+    * of its fields in up to 'nmemb' members of the 'fields' array. You can
+    * call this function with NULL instead of a pointer to an output array,
+    * to find out how many fields a record has. An empty record has no
+    * fields. The reader must not be at the end of its input.
+    * Returns: The number of fields that would have been stored in the
+    *          'fields' array if it had been specified and 'nmemb' was big
+    *          enough.
+    */
+
+size_t csv_reader_parse(CSVReader * /*reader*/,
+                        const CSVFieldType * /*schema*/,
+                        CSVValue * /*output*/, size_t /*nmemb*/);
+   /*
+    * Reads the next record from a given reader and assigns the value of
+    * each of its fields to up to 'nmemb' members of the 'output' array.
+    * Each member of the 'schema' array specifies how to interpret the
+    * field with the same index. Numeric values are converted as for
+    * csv_parse_string; other values are stored as field views.
+    * The reader must not be at the end of its input.
+    * Returns: The number of fields that would have been read into the
+    *          'output' array if it had been specified and 'nmemb' was big
+    *          enough.
+    */
+
+typedef enum
+{
+  CSVError_None,     /* No error */
+  CSVError_BadValue, /* A field is empty, is not a number or has
+                        unexpected characters after a number */
+  CSVError_Range,    /* A number is too big to be represented */
+  CSVError_BadQuote  /* A quoted field has no closing quote or has
+                        unexpected characters after its closing quote */
+}
+CSVErrorType;
+
+typedef struct
+{
+  CSVErrorType type;   /* Type of the first error in a record. */
+  size_t       record; /* Index of the record, counting from 0. */
+  size_t       field;  /* Index of the field within that record. */
+  size_t       offset; /* Offset of the start of that field, in bytes
+                          from the start of the reader's input string. */
+}
+CSVError;
+   /*
+    * Describes where and why a record could not be parsed.
+    */
+
+size_t csv_reader_parse_strict(CSVReader * /*reader*/,
+                               const CSVFieldType * /*schema*/,
+                               CSVValue * /*output*/, size_t /*nmemb*/,
+                               CSVError * /*error*/);
+   /*
+    * Like csv_reader_parse except that each numeric field is checked to
+    * have been fully consumed and for overflow, and each quoted field is
+    * checked to be properly terminated. Details of the first error found
+    * are stored in the object pointed to by 'error'; if none was found,
+    * its 'type' member is set to CSVError_None. Values are stored as for
+    * csv_reader_parse regardless of errors, and the reader is advanced to
+    * the next record so that parsing can continue. Fields beyond the
+    * first 'nmemb' are only checked for quoting errors.
+    * Returns: The number of fields that would have been read into the
+    *          'output' array if it had been specified and 'nmemb' was big
+    *          enough.
+    */
+
+size_t csv_field_unquote(const CSVField * /*field*/, char * /*s1*/,
+                         size_t /*n*/);
+   /*
+    * Copies the characters of a field into the array pointed to by s1,
+    * replacing each pair of quotes with a single quote character. If n is
+    * zero, nothing is written and s1 may be a null pointer. Otherwise,
+    * output characters beyond the n-1st are discarded and a null character
+    * is written at the end of the characters actually written into the
+    * array.
+    * Returns: the number of characters that would have been written had n
+    *          been sufficiently large, not counting the terminating null
+    *          character.
+    */
+
+typedef struct
+{
+  size_t records;    /* Number of records. */
+  size_t max_fields; /* Greatest number of fields in any record. */
+  size_t fields;     /* Total number of fields in all records. */
+}
+CSVCounts;
+
+void csv_scan(const char * /*s*/, size_t /*len*/, CSVCounts * /*counts*/);
+   /*
+    * Counts the records in the first 'len' characters of the string 's'
+    * and the fields in those records, without converting any values. The
+    * scan stops early at a nul terminator. Records and fields are counted
+    * as they would be by a CSVReader, including quoted fields that contain
+    * commas or line endings. The results can be used to allocate exactly
+    * enough storage before parsing.
+    */
+
+void csv_scan_format(const char * /*s*/, size_t /*len*/,
+                     const CSVFormat * /*format*/, CSVCounts * /*counts*/);
+   /*
+    * Like csv_scan except that the records are counted as they would be by
+    * a CSVReader initialized with the given format, or the default format
+    * if 'format' is a null pointer.
+    */
+
+typedef enum
+{
+  CSVLineEnding_LF,   /* Line feed (RISC OS style) */
+  CSVLineEnding_CR,   /* Carriage return (Mac style) */
+  CSVLineEnding_CRLF, /* Carriage return, line feed (DOS style) */
+  CSVLineEnding_LFCR  /* Line feed, carriage return (VDU style) */
+}
+CSVLineEnding;
+
+bool csv_write_record(StringBuffer * /*buffer*/, const void * /*input*/,
+  CSVOutputType /*type*/, size_t /*nmemb*/, char /*separator*/,
+  CSVLineEnding /*line_ending*/);
+   /*
+    * Appends a record consisting of the 'nmemb' numeric values in the
+    * 'input' array, followed by a line ending, at the end of the current
+    * string in a given buffer. The 'type' argument specifies the type of
+    * the elements of the 'input' array. Values are separated by the given
+    * 'separator' character. Each double value is written with the fewest
+    * decimal places (or significant digits, up to 17) needed for it to be
+    * read back exactly, using '.' as the decimal point whatever the
+    * current locale.
+    * On failure, the string is unmodified. On success, the effects of this
+    * function can be undone atomically.
+    * Returns: true if successful, or false if additional space was required
+    *          but could not be allocated.
+    */
+
+static inline bool csv_write_as_int(StringBuffer *const buffer,
+  const int *const input, size_t const nmemb, char const separator,
+  CSVLineEnding const line_ending)
+{
+  return csv_write_record(buffer, input, CSVOutputType_Int, nmemb,
+                          separator, line_ending);
+}
+
+static inline bool csv_write_as_long(StringBuffer *const buffer,
+  const long int *const input, size_t const nmemb, char const separator,
+  CSVLineEnding const line_ending)
+{
+  return csv_write_record(buffer, input, CSVOutputType_Long, nmemb,
+                          separator, line_ending);
+}
+
+static inline bool csv_write_as_double(StringBuffer *const buffer,
+  const double *const input, size_t const nmemb, char const separator,
+  CSVLineEnding const line_ending)
+{
+  return csv_write_record(buffer, input, CSVOutputType_Double, nmemb,
+                          separator, line_ending);
+}
+
+bool csv_fwrite_record(FILE * /*f*/, const void * /*input*/,
+  CSVOutputType /*type*/, size_t /*nmemb*/, char /*separator*/,
+  CSVLineEnding /*line_ending*/);
+   /*
+    * Like csv_write_record except that the record is written to a given
+    * stream. Values are formatted in batches to reduce the number of calls
+    * to the underlying output function.
+    * Returns: true if successful, or false if a write error occurred.
+    */
+
 /* Deprecated type and enumeration constant names */
 #define parse_csv_type    CSVOutputType
 #define CSV_OUTPUT_TYPE_I CSVOutputType_Int
@@ -0,0 +1,501 @@
+/*
+ * CBUtilLib: Read records and fields in comma-separated value format
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* History:
+  CJB: 17-Oct-26: Created this source file.
+*/
+
+/* ISO library headers */
+#include <limits.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <math.h>
+#include <string.h>
+#include <stdbool.h>
+
+/* Local headers */
+#include "CSV.h"
+#include "Internal/CBUtilMisc.h"
+
+enum
+{
+  MaxNumberLen = 64, /* Longest field that will be copied in order to
+                        translate its decimal point */
+};
+
+typedef const char *ScanFieldFn(const char *s, CSVField *f, char separator);
+
+/* Defines a function to find the extent of the field beginning at 's'.
+   The function returns a pointer to the separator, line ending or nul
+   terminator at the end of the field. Specialised variants are generated
+   for common separators by substituting a constant for SEPARATOR, which
+   lets the compiler optimise the innermost loops; the generic variant
+   uses the 'separator' argument instead. */
+#define DEFINE_SCAN_FIELD(name, SEPARATOR) \
+static const char *name(const char *s, CSVField *const f, \
+                        char const separator) \
+{ \
+  assert(s != NULL); \
+  assert(f != NULL); \
+  NOT_USED(separator); \
+\
+  *f = (CSVField){.quoted = false, .escaped = false}; \
+\
+  if (*s == '"') \
+  { \
+    /* A quoted field ends at the next quote that isn't part of a pair. \
+       It may contain separators and line endings. */ \
+    f->quoted = true; \
+    f->start = ++s; \
+    while (*s != '\0') \
+    { \
+      if (*s == '"') \
+      { \
+        if (s[1] != '"') \
+        { \
+          break; \
+        } \
+        f->escaped = true; \
+        ++s; \
+      } \
+      ++s; \
+    } \
+    assert(s >= f->start); \
+    f->len = (size_t)(s - f->start); \
+\
+    if (*s == '"') \
+    { \
+      ++s; /* skip the closing quote */ \
+    } \
+    else \
+    { \
+      DEBUGF("CSV: Unterminated quoted field\n"); \
+    } \
+\
+    /* Ignore anything between the closing quote and the separator */ \
+    while (*s != (SEPARATOR) && *s != '\n' && *s != '\r' && *s != '\0') \
+    { \
+      ++s; \
+    } \
+  } \
+  else \
+  { \
+    f->start = s; \
+    while (*s != (SEPARATOR) && *s != '\n' && *s != '\r' && *s != '\0') \
+    { \
+      ++s; \
+    } \
+    f->len = (size_t)(s - f->start); \
+  } \
+\
+  DEBUG_VERBOSEF("CSV: Field is '%.*s'\n", (int)f->len, f->start); \
+  return s; \
+}
+
+DEFINE_SCAN_FIELD(scan_field_comma, ',')
+DEFINE_SCAN_FIELD(scan_field_tab, '\t')
+DEFINE_SCAN_FIELD(scan_field_semicolon, ';')
+DEFINE_SCAN_FIELD(scan_field_any, separator)
+
+static ScanFieldFn *select_scan_field(char const separator)
+{
+  switch (separator)
+  {
+    case ',':
+      return scan_field_comma;
+    case '\t':
+      return scan_field_tab;
+    case ';':
+      return scan_field_semicolon;
+    default:
+      return scan_field_any;
+  }
+}
+
+static const char *skip_line_ending(const char *const s)
+{
+  /* Returns a pointer to the first character of the next record, or
+     NULL if the end of the input string was reached. */
+  assert(s != NULL);
+
+  switch (*s)
+  {
+    case '\n':
+      /* Check for LF/CR line ending (VDU style) */
+      return s[1] == '\r' ? s + 2 : s + 1;
+
+    case '\r':
+      /* Check for CR/LF line ending (DOS style) */
+      return s[1] == '\n' ? s + 2 : s + 1;
+
+    default:
+      assert(*s == '\0');
+      DEBUGF("CSV: End of input string\n");
+      return NULL;
+  }
+}
+
+static const char *skip_comments(const char *s, char const comment)
+{
+  /* Returns a pointer to the first record that isn't a comment line. */
+  assert(s != NULL);
+
+  while (comment != '\0' && *s == comment)
+  {
+    const char *const end = strpbrk(s, "\r\n");
+    if (end == NULL)
+    {
+      DEBUGF("CSV: Comment line at end of input string\n");
+      return s + strlen(s);
+    }
+    DEBUGF("CSV: Skipping comment line '%.*s'\n", (int)(end - s), s);
+    s = skip_line_ending(end);
+    assert(s != NULL);
+  }
+  return s;
+}
+
+static CSVErrorType check_end(const CSVField *const field,
+                              const char *const endptr)
+{
+  /* Numeric conversion functions skip leading white-space, which might
+     include a line ending, so don't allow them to read beyond the field.
+     Also check that the whole field was consumed. */
+  assert(field != NULL);
+  assert(endptr != NULL);
+
+  return (endptr == field->start || endptr != field->start + field->len) ?
+         CSVError_BadValue : CSVError_None;
+}
+
+static CSVErrorType convert_double(const CSVField *const field,
+                                   char const decimal_point,
+                                   double *const value)
+{
+  assert(field != NULL);
+  assert(value != NULL);
+
+  CSVField number = *field;
+  char copy[MaxNumberLen];
+
+  if (decimal_point != '.')
+  {
+    /* strtod only recognises the decimal point of the current locale, so
+       convert a copy of the field in which the decimal point is swapped
+       with a full stop. No valid number is too long to copy. */
+    if (field->len >= sizeof(copy))
+    {
+      *value = 0.0;
+      return CSVError_BadValue;
+    }
+
+    for (size_t i = 0; i < field->len; ++i)
+    {
+      char const c = field->start[i];
+      copy[i] = (c == decimal_point) ? '.' : (c == '.') ? decimal_point : c;
+    }
+    copy[field->len] = '\0';
+    number.start = copy;
+  }
+
+  char *endptr;
+  errno = 0;
+  *value = strtod(number.start, &endptr);
+
+  CSVErrorType err = check_end(&number, endptr);
+  if (err != CSVError_None && endptr > number.start + number.len)
+  {
+    *value = 0.0;
+  }
+  else if (err == CSVError_None && errno == ERANGE &&
+           (*value == HUGE_VAL || *value == -HUGE_VAL))
+  {
+    /* Underflow isn't an error because the result is still close */
+    err = CSVError_Range;
+  }
+  return err;
+}
+
+static CSVErrorType convert_field(const CSVField *const field,
+                                  CSVFieldType const type,
+                                  char const decimal_point,
+                                  CSVValue *const value)
+{
+  /* Converts a field to a value of the given type. Invalid values are
+     converted to 0 and out-of-range integers are clamped, but the reason is
+     returned so that it can be reported. */
+  assert(field != NULL);
+  assert(value != NULL);
+
+  char *endptr;
+  CSVErrorType err = CSVError_None;
+
+  switch (type)
+  {
+    case CSVFieldType_Double:
+      err = convert_double(field, decimal_point, &value->as_double);
+      DEBUGF("CSV: Decoded field as %f\n", value->as_double);
+      break;
+
+    case CSVFieldType_Long:
+      errno = 0;
+      value->as_long = strtol(field->start, &endptr, 0);
+      err = check_end(field, endptr);
+      if (err != CSVError_None && endptr > field->start + field->len)
+      {
+        value->as_long = 0;
+      }
+      else if (err == CSVError_None && errno == ERANGE)
+      {
+        err = CSVError_Range;
+      }
+      DEBUGF("CSV: Decoded field as %li\n", value->as_long);
+      break;
+
+    case CSVFieldType_Int:
+      {
+        errno = 0;
+        long int tmp = strtol(field->start, &endptr, 0);
+        err = check_end(field, endptr);
+        if (err != CSVError_None && endptr > field->start + field->len)
+        {
+          tmp = 0;
+        }
+        else if (err == CSVError_None &&
+                 (errno == ERANGE || tmp < INT_MIN || tmp > INT_MAX))
+        {
+          err = CSVError_Range;
+        }
+        value->as_int = (int)LOWEST(INT_MAX, HIGHEST(INT_MIN, tmp));
+        DEBUGF("CSV: Decoded field as %i\n", value->as_int);
+      }
+      break;
+
+    case CSVFieldType_String:
+      value->as_string = *field;
+      break;
+  }
+
+  return err;
+}
+
+static CSVErrorType check_quotes(const CSVField *const field,
+                                 const char *const end)
+{
+  /* A quoted field must have a closing quote, which must be immediately
+     followed by a separator or line ending. */
+  assert(field != NULL);
+  assert(end != NULL);
+
+  if (!field->quoted)
+  {
+    return CSVError_None;
+  }
+
+  const char *const quote = field->start + field->len;
+  return (*quote == '"' && quote + 1 == end) ?
+         CSVError_None : CSVError_BadQuote;
+}
+
+static void set_error(CSVError *const error, CSVErrorType const type,
+                      const CSVReader *const reader, size_t const field,
+                      const char *const s)
+{
+  /* Records the first error in a record */
+  assert(reader != NULL);
+  assert(s >= reader->input);
+
+  if (error != NULL && type != CSVError_None &&
+      error->type == CSVError_None)
+  {
+    *error = (CSVError){
+      .type = type,
+      .record = reader->record,
+      .field = field,
+      .offset = (size_t)(s - reader->input),
+    };
+    DEBUGF("CSV: Error %d in record %zu, field %zu at offset %zu\n",
+           (int)type, error->record, error->field, error->offset);
+  }
+}
+
+static size_t read_record(CSVReader *const reader,
+                          const CSVFieldType *const schema,
+                          void *const output, size_t const nmemb,
+                          CSVError *const error)
+{
+  /* Reads the next record from a given reader. If a schema is specified
+     then the output is an array of values, otherwise it is an array of
+     field views. Errors are only checked if 'error' is not null. */
+  assert(reader != NULL);
+  assert(!csv_reader_at_end(reader));
+
+  const char *s = reader->next;
+  size_t field = 0;
+  CSVFormat const *const format = &reader->format;
+  ScanFieldFn *const scan_field = select_scan_field(format->separator);
+
+  if (error != NULL)
+  {
+    *error = (CSVError){.type = CSVError_None};
+  }
+
+  /* We handle empty records as a special case because we don't want to
+     interpret them as a single empty field. */
+  if (*s == '\n' || *s == '\r' || *s == '\0')
+  {
+    DEBUGF("CSV: Empty record\n");
+  }
+  else
+  {
+    for (;;)
+    {
+      CSVField f;
+      const char *const start = s;
+      s = scan_field(s, &f, format->separator);
+
+      if (error != NULL)
+      {
+        set_error(error, check_quotes(&f, s), reader, field, start);
+      }
+
+      if (output != NULL && field < nmemb)
+      {
+        if (schema != NULL)
+        {
+          CSVValue *const values = output;
+          CSVErrorType const err = convert_field(&f, schema[field],
+                                                 format->decimal_point,
+                                                 &values[field]);
+          if (error != NULL)
+          {
+            set_error(error, err, reader, field, start);
+          }
+        }
+        else
+        {
+          CSVField *const fields = output;
+          fields[field] = f;
+        }
+      }
+      field++;
+
+      if (*s != format->separator)
+      {
+        break;
+      }
+      ++s; /* skip the separator */
+    }
+  }
+
+  reader->next = skip_line_ending(s);
+  if (reader->next != NULL)
+  {
+    reader->next = skip_comments(reader->next, format->comment);
+  }
+  reader->record++;
+
+  DEBUGF("CSV: Record %zu has %zu fields\n", reader->record, field);
+  return field;
+}
+
+/* -----------------------------------------------------------------------
+                         Public library functions
+*/
+
+void csv_reader_init(CSVReader *const reader, const char *const s)
+{
+  csv_reader_init_format(reader, s, NULL);
+}
+
+void csv_reader_init_format(CSVReader *const reader, const char *const s,
+                            const CSVFormat *const format)
+{
+  assert(reader != NULL);
+  assert(s != NULL);
+  DEBUGF("CSV: Initializing reader %p for string %p\n", (void *)reader,
+         (void *)s);
+
+  *reader = (CSVReader){
+    .input = s,
+    .record = 0,
+    .format = format != NULL ? *format : csv_format_default(),
+  };
+
+  assert(reader->format.separator != '\0');
+  assert(reader->format.separator != '"');
+  assert(reader->format.separator != reader->format.decimal_point);
+  assert(reader->format.comment != '"');
+
+  reader->next = skip_comments(s, reader->format.comment);
+}
+
+size_t csv_reader_split(CSVReader *const reader, CSVField *const fields,
+                        size_t const nmemb)
+{
+  return read_record(reader, NULL, fields, nmemb, NULL);
+}
+
+size_t csv_reader_parse(CSVReader *const reader,
+                        const CSVFieldType *const schema,
+                        CSVValue *const output, size_t const nmemb)
+{
+  assert(schema != NULL || output == NULL);
+  return read_record(reader, schema, output, nmemb, NULL);
+}
+
+size_t csv_reader_parse_strict(CSVReader *const reader,
+                               const CSVFieldType *const schema,
+                               CSVValue *const output, size_t const nmemb,
+                               CSVError *const error)
+{
+  assert(schema != NULL || output == NULL);
+  assert(error != NULL);
+  return read_record(reader, schema, output, nmemb, error);
+}
+
+size_t csv_field_unquote(const CSVField *const field, char *const s1,
+                         size_t const n)
+{
+  assert(field != NULL);
+  assert(s1 != NULL || n == 0);
+
+  size_t count = 0;
+  for (size_t i = 0; i < field->len; ++i)
+  {
+    if (field->escaped && field->start[i] == '"')
+    {
+      ++i; /* skip the second quote of a pair */
+      assert(i < field->len);
+    }
+
+    if (count + 1 < n)
+    {
+      s1[count] = field->start[i];
+    }
+    ++count;
+  }
+
+  if (n > 0)
+  {
+    s1[LOWEST(count, n - 1)] = '\0';
+  }
+
+  return count;
+}
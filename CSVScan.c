@@ -0,0 +1,210 @@
+/*
+ * CBUtilLib: Count records and fields in comma-separated value format
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* History:
+  CJB: 17-Oct-26: Created this source file.
+*/
+
+/* ISO library headers */
+#include <stddef.h>
+#include <string.h>
+
+/* Local headers */
+#include "CSV.h"
+#include "Internal/WordScan.h"
+#include "Internal/CBUtilMisc.h"
+
+static const char *find_field_end(const char *p, const char *const end,
+                                  char const separator)
+{
+  /* Finds the separator, line ending or nul terminator at the end of an
+     unquoted field, skipping whole words that don't contain any of them.
+     Returns 'end' if none was found. The cost of checking for a separator
+     is the same whether or not it is a constant. */
+  assert(p != NULL);
+  assert(end >= p);
+
+  while ((size_t)(end - p) >= sizeof(Word))
+  {
+    Word w;
+    memcpy(&w, p, sizeof(w));
+    if (HAS_BYTE(w, separator) | HAS_BYTE(w, '\n') | HAS_BYTE(w, '\r') |
+        HAS_ZERO_BYTE(w))
+    {
+      break;
+    }
+    p += sizeof(Word);
+  }
+
+  for (; p < end; ++p)
+  {
+    if (*p == separator || *p == '\n' || *p == '\r' || *p == '\0')
+    {
+      break;
+    }
+  }
+  return p;
+}
+
+static const char *find_quote(const char *p, const char *const end)
+{
+  /* Finds the next quote or nul terminator, skipping whole words that
+     don't contain either. Returns 'end' if neither was found. */
+  assert(p != NULL);
+  assert(end >= p);
+
+  while ((size_t)(end - p) >= sizeof(Word))
+  {
+    Word w;
+    memcpy(&w, p, sizeof(w));
+    if (HAS_BYTE(w, '"') | HAS_ZERO_BYTE(w))
+    {
+      break;
+    }
+    p += sizeof(Word);
+  }
+
+  for (; p < end; ++p)
+  {
+    if (*p == '"' || *p == '\0')
+    {
+      break;
+    }
+  }
+  return p;
+}
+
+static const char *skip_quoted(const char *p, const char *const end)
+{
+  /* Skips a quoted field, starting after the opening quote. Returns a
+     pointer to the character after the closing quote, or to the end of
+     the input if there is no closing quote. */
+  assert(p != NULL);
+  assert(end >= p);
+
+  for (;;)
+  {
+    p = find_quote(p, end);
+    if (p == end || *p != '"')
+    {
+      DEBUGF("CSV: Unterminated quoted field\n");
+      return p;
+    }
+
+    if (end - p < 2 || p[1] != '"')
+    {
+      return p + 1; /* skip the closing quote */
+    }
+    p += 2; /* skip a pair of quotes */
+  }
+}
+
+static const char *skip_line_ending(const char *const p,
+                                    const char *const end)
+{
+  /* Skips a line ending of one or two characters */
+  assert(p != NULL);
+  assert(p < end);
+  assert(*p == '\n' || *p == '\r');
+
+  if (end - p >= 2 &&
+      ((p[0] == '\n' && p[1] == '\r') || (p[0] == '\r' && p[1] == '\n')))
+  {
+    return p + 2;
+  }
+  return p + 1;
+}
+
+/* -----------------------------------------------------------------------
+                         Public library functions
+*/
+
+void csv_scan(const char *const s, size_t const len, CSVCounts *const counts)
+{
+  csv_scan_format(s, len, NULL, counts);
+}
+
+void csv_scan_format(const char *const s, size_t const len,
+                     const CSVFormat *format, CSVCounts *const counts)
+{
+  assert(s != NULL);
+  assert(counts != NULL);
+  DEBUGF("CSV: Will scan %zu bytes from %p\n", len, (void *)s);
+
+  CSVFormat const default_format = csv_format_default();
+  if (format == NULL)
+  {
+    format = &default_format;
+  }
+  assert(format->separator != '\0');
+  assert(format->separator != '"');
+
+  *counts = (CSVCounts){.records = 0, .max_fields = 0, .fields = 0};
+
+  const char *p = s, *const end = s + len;
+  for (;;)
+  {
+    /* Skip comment lines. Using a line ending as the separator finds the
+       end of the line. */
+    while (format->comment != '\0' && p < end && *p == format->comment)
+    {
+      p = find_field_end(p, end, '\n');
+      if (p < end && *p != '\0')
+      {
+        p = skip_line_ending(p, end);
+      }
+    }
+
+    /* Count the fields in one record. As when reading, an empty record
+       has no fields and quotes are only special at the start of a field. */
+    size_t nfields = 0;
+    if (p < end && *p != '\n' && *p != '\r' && *p != '\0')
+    {
+      for (;;)
+      {
+        ++nfields;
+        if (p < end && *p == '"')
+        {
+          p = skip_quoted(p + 1, end);
+        }
+
+        p = find_field_end(p, end, format->separator);
+        if (p == end || *p != format->separator)
+        {
+          break;
+        }
+        ++p; /* skip the separator */
+      }
+    }
+
+    counts->records++;
+    counts->fields += nfields;
+    counts->max_fields = HIGHEST(counts->max_fields, nfields);
+
+    if (p == end || *p == '\0')
+    {
+      break;
+    }
+
+    p = skip_line_ending(p, end);
+  }
+
+  DEBUGF("CSV: Found %zu records with up to %zu fields (%zu in total)\n",
+         counts->records, counts->max_fields, counts->fields);
+}
@@ -0,0 +1,353 @@
+/*
+ * CBUtilLib: Write signed decimal values in comma-separated value format
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* History:
+  CJB: 17-Oct-26: Created this source file.
+                  Format doubles with few decimal places without sprintf,
+                  and always use '.' as the decimal point.
+*/
+
+/* ISO library headers */
+#include <limits.h>
+#include <locale.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Local headers */
+#include "CSV.h"
+#include "StringBuff.h"
+#include "Internal/CBUtilMisc.h"
+
+enum
+{
+  MaxNumberLen = 32,    /* Enough for "-1.2345678901234567e-308" or the
+                           decimal digits of a 64-bit integer, plus a
+                           nul terminator */
+  MaxLineEndingLen = 2,
+  ChunkSize = 256,      /* Size of the batch written to a stream */
+  MinDoublePrecision = 15,
+  MaxDoublePrecision = 17,
+  MaxDecimalPlaces = 15, /* Beyond this, use sprintf */
+};
+
+/* Every integer of this magnitude or less can be stored exactly in a
+   double (assuming a 53-bit significand). */
+#define MaxExactInteger 9007199254740992.0
+
+static const double powers_of_ten[MaxDecimalPlaces + 1] =
+{
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12,
+  1e13, 1e14, 1e15
+};
+
+static size_t format_long(char *const s, long int const value)
+{
+  /* Formats an integer without parsing a format string. */
+  assert(s != NULL);
+
+  char digits[MaxNumberLen];
+  unsigned long int magnitude = value < 0 ? 0ul - (unsigned long)value :
+                                            (unsigned long)value;
+  size_t ndigits = 0;
+  do
+  {
+    assert(ndigits < sizeof(digits));
+    digits[ndigits++] = (char)('0' + (int)(magnitude % 10));
+    magnitude /= 10;
+  }
+  while (magnitude > 0);
+
+  size_t len = 0;
+  if (value < 0)
+  {
+    s[len++] = '-';
+  }
+  while (ndigits > 0)
+  {
+    s[len++] = digits[--ndigits];
+  }
+  return len;
+}
+
+static size_t format_decimal(char *const s, double const value)
+{
+  /* Finds the fewest decimal places with which an integer divided by
+     a power of ten is exactly the given value. Both the integer and the
+     power of ten are exact and division is correctly rounded, so strtod
+     would read the same value back from the decimal string. Returns 0 if
+     there is no such integer small enough to be exact. */
+  assert(s != NULL);
+
+  double const magnitude = value < 0 ? -value : value;
+  if (!(magnitude < MaxExactInteger))
+  {
+    return 0; /* too big, infinite or not a number */
+  }
+
+  for (size_t places = 0; places <= MaxDecimalPlaces; ++places)
+  {
+    double const scaled = magnitude * powers_of_ten[places];
+    if (scaled >= MaxExactInteger)
+    {
+      break;
+    }
+
+    unsigned long long const integer = (unsigned long long)(scaled + 0.5);
+    if ((double)integer / powers_of_ten[places] != magnitude)
+    {
+      continue;
+    }
+
+    char digits[MaxNumberLen];
+    size_t ndigits = 0;
+    unsigned long long rest = integer;
+    do
+    {
+      assert(ndigits < sizeof(digits));
+      digits[ndigits++] = (char)('0' + (int)(rest % 10));
+      rest /= 10;
+    }
+    while (rest > 0);
+
+    /* Zero is signed, so check the sign bit rather than the value */
+    size_t len = 0;
+    if (signbit(value))
+    {
+      s[len++] = '-';
+    }
+
+    /* Pad with zeros so that there is at least one integer digit */
+    while (ndigits <= places)
+    {
+      assert(ndigits < sizeof(digits));
+      digits[ndigits++] = '0';
+    }
+
+    while (ndigits > 0)
+    {
+      if (ndigits == places)
+      {
+        s[len++] = '.';
+      }
+      s[len++] = digits[--ndigits];
+    }
+
+    assert(len < MaxNumberLen);
+    return len;
+  }
+
+  return 0;
+}
+
+static size_t format_double(char *const s, double const value)
+{
+  /* Most values have few enough decimal places to be formatted without
+     sprintf. Otherwise, try increasing precision until the formatted
+     value can be read back exactly. */
+  assert(s != NULL);
+
+  size_t len = format_decimal(s, value);
+  if (len > 0)
+  {
+    return len;
+  }
+
+  for (int precision = MinDoublePrecision; ; ++precision)
+  {
+    int const n = sprintf(s, "%.*g", precision, value);
+    assert(n > 0 && n < MaxNumberLen);
+    len = (size_t)n;
+    if (precision >= MaxDoublePrecision || strtod(s, NULL) == value)
+    {
+      break;
+    }
+  }
+
+  /* Don't let a locale in which the decimal point is a comma (for
+     example) corrupt a comma-separated record. */
+  char const decimal_point = localeconv()->decimal_point[0];
+  if (decimal_point != '.')
+  {
+    char *const point = memchr(s, decimal_point, len);
+    if (point != NULL)
+    {
+      *point = '.';
+    }
+  }
+
+  return len;
+}
+
+static size_t format_value(char *const s, const void *const input,
+                           CSVOutputType const type, size_t const index)
+{
+  /* Formats one value. Space must be available for MaxNumberLen
+     characters. */
+  assert(input != NULL);
+
+  switch (type)
+  {
+    case CSVOutputType_Double:
+      {
+        const double *const input_f = input;
+        return format_double(s, input_f[index]);
+      }
+
+    case CSVOutputType_Long:
+      {
+        const long *const input_l = input;
+        return format_long(s, input_l[index]);
+      }
+
+    case CSVOutputType_Int:
+      {
+        const int *const input_i = input;
+        return format_long(s, input_i[index]);
+      }
+  }
+
+  assert("Bad output type" == NULL);
+  return 0;
+}
+
+static size_t format_line_ending(char *const s,
+                                 CSVLineEnding const line_ending)
+{
+  assert(s != NULL);
+
+  switch (line_ending)
+  {
+    case CSVLineEnding_LF:
+      s[0] = '\n';
+      return 1;
+
+    case CSVLineEnding_CR:
+      s[0] = '\r';
+      return 1;
+
+    case CSVLineEnding_CRLF:
+      s[0] = '\r';
+      s[1] = '\n';
+      return 2;
+
+    case CSVLineEnding_LFCR:
+      s[0] = '\n';
+      s[1] = '\r';
+      return 2;
+  }
+
+  assert("Bad line ending" == NULL);
+  return 0;
+}
+
+/* -----------------------------------------------------------------------
+                         Public library functions
+*/
+
+bool csv_write_record(StringBuffer *const buffer, const void *const input,
+  CSVOutputType const type, size_t const nmemb, char const separator,
+  CSVLineEnding const line_ending)
+{
+  assert(buffer != NULL);
+  assert(input != NULL || nmemb == 0);
+  assert(type == CSVOutputType_Int || type == CSVOutputType_Long ||
+         type == CSVOutputType_Double);
+  DEBUGF("CSV: Will write %zu members of array %p to buffer %p\n",
+         nmemb, input, (void *)buffer);
+
+  /* Reserve enough space for the longest possible record so that values
+     can be formatted straight into the buffer. */
+  if (nmemb > (SIZE_MAX - MaxLineEndingLen - 1) / MaxNumberLen)
+  {
+    return false;
+  }
+
+  size_t min_size = (nmemb * MaxNumberLen) + MaxLineEndingLen + 1;
+  char *const free_ptr = stringbuffer_prepare_append(buffer, &min_size);
+  if (free_ptr == NULL)
+  {
+    return false;
+  }
+
+  size_t len = 0;
+  for (size_t i = 0; i < nmemb; ++i)
+  {
+    if (i > 0)
+    {
+      free_ptr[len++] = separator;
+    }
+    len += format_value(free_ptr + len, input, type, i);
+  }
+  len += format_line_ending(free_ptr + len, line_ending);
+  assert(len < min_size);
+
+  stringbuffer_finish_append(buffer, len);
+  return true;
+}
+
+bool csv_fwrite_record(FILE *const f, const void *const input,
+  CSVOutputType const type, size_t const nmemb, char const separator,
+  CSVLineEnding const line_ending)
+{
+  assert(f != NULL);
+  assert(input != NULL || nmemb == 0);
+  assert(type == CSVOutputType_Int || type == CSVOutputType_Long ||
+         type == CSVOutputType_Double);
+  DEBUGF("CSV: Will write %zu members of array %p to stream %p\n",
+         nmemb, input, (void *)f);
+
+  char chunk[ChunkSize];
+  size_t len = 0;
+
+  for (size_t i = 0; i < nmemb; ++i)
+  {
+    /* Write the batch of formatted values if there might not be enough
+       space for another. */
+    if (len + 1 + MaxNumberLen > sizeof(chunk))
+    {
+      if (fwrite(chunk, len, 1, f) != 1)
+      {
+        return false;
+      }
+      len = 0;
+    }
+
+    if (i > 0)
+    {
+      chunk[len++] = separator;
+    }
+    len += format_value(chunk + len, input, type, i);
+  }
+
+  if (len + MaxLineEndingLen > sizeof(chunk))
+  {
+    if (fwrite(chunk, len, 1, f) != 1)
+    {
+      return false;
+    }
+    len = 0;
+  }
+  len += format_line_ending(chunk + len, line_ending);
+
+  return fwrite(chunk, len, 1, f) == 1;
+}
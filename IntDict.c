@@ -25,11 +25,19 @@
   CJB: 29-Aug-22: Fix text of debug output from intdict_find_specific.
   CJB: 17-Jun-23: Include "CBUtilMisc.h" last in case any of the other
                   included header files redefine macros such as assert().
+  CJB: 17-Oct-26: Insertion no longer searches for the position of a key
+                  greater than all others. Added an append function.
+                  Removing items from the head of a dictionary no longer
+                  moves the remaining items.
+                  Added rank, quantile and range sum queries, with an
+                  optional index of cumulative sums.
  */
 
 #include <stdlib.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
+#include <limits.h>
 
 #include "IntDict.h"
 #include "Internal/CBUtilMisc.h"
@@ -37,8 +45,24 @@
 enum {
   ArrayInitSize = 4,
   ArrayGrowthFactor = 2,
+  ArrayReclaimDivisor = 4,
 };
 
+static IntDictItem *get_base(IntDict const *const dict)
+{
+  /* Items removed from the head of the array leave space before it
+     that is reclaimed when the array next needs to grow. */
+  assert(dict);
+  return dict->offset > 0 ? dict->array - dict->offset : dict->array;
+}
+
+static unsigned long long *get_sums_base(IntDict const *const dict)
+{
+  assert(dict);
+  return dict->sums && dict->offset > 0 ? dict->sums - dict->offset :
+                                          dict->sums;
+}
+
 void intdict_init(IntDict *const dict)
 {
   DEBUGF("Initializing integer dictionary %p\n", (void *)dict);
@@ -61,7 +85,8 @@ void intdict_destroy(IntDict *const dict,
     }
   }
 
-  free(dict->array);
+  free(get_sums_base(dict));
+  free(get_base(dict));
 }
 
 static int compare_key_n_item(const void *const key, const void *const item)
@@ -93,6 +118,11 @@ void intdict_remove_at(IntDict *const dict, size_t const index)
   assert(dict->nitems <= dict->nalloc);
   assert(index < dict->nitems);
 
+  if (index == 0) {
+    intdict_remove_head(dict, 1);
+    return;
+  }
+
   DEBUGF("Removing item with key %" PRIIntDictKey
          ", value %p at position %zu in dictionary %p of size %zu\n",
          dict->array[index].key, dict->array[index].value, index,
@@ -102,6 +132,14 @@ void intdict_remove_at(IntDict *const dict, size_t const index)
   dict->nitems--;
 
   size_t const nitems = dict->nitems;
+  if (dict->sums) {
+    unsigned long long const key = (unsigned long long)dict->array[index].key;
+    for (size_t i = index; i < nitems; ++i) {
+      dict->sums[i] = dict->sums[i + 1] - key;
+    }
+    dict->sum_total -= key;
+  }
+
   for (size_t i = index; i < nitems; ++i) {
     assert(i + 1 < dict->nalloc);
     dict->array[i] = dict->array[i + 1];
@@ -124,6 +162,40 @@ void intdict_remove_at(IntDict *const dict, size_t const index)
 #endif
 }
 
+void intdict_remove_head(IntDict *const dict, size_t const count)
+{
+  assert(dict);
+  assert(dict->nitems <= dict->nalloc);
+  assert(count <= dict->nitems);
+
+  DEBUGF("Removing %zu items from the head of dictionary %p of size %zu\n",
+         count, (void *)dict, dict->nitems);
+
+  if (count == 0) {
+    return;
+  }
+
+  /* Advance the start of the array instead of moving the remaining items */
+  dict->candidate = NULL;
+  dict->array += count;
+  if (dict->sums) {
+    dict->sums += count;
+  }
+  dict->offset += count;
+  dict->nalloc -= count;
+  dict->nitems -= count;
+
+  if (dict->nitems == 0) {
+    DEBUGF("Reclaiming %zu unused items\n", dict->offset);
+    dict->array -= dict->offset;
+    if (dict->sums) {
+      dict->sums -= dict->offset;
+    }
+    dict->nalloc += dict->offset;
+    dict->offset = 0;
+  }
+}
+
 void *intdict_remove_value_at(IntDict *const dict, size_t const index)
 {
   assert(dict);
@@ -184,44 +256,101 @@ bool intdict_find_specific(IntDict *const dict, IntDictKey const key,
   return true;
 }
 
-bool intdict_insert(IntDict *const dict, IntDictKey const key,
-                    void *const value, size_t *const index)
+static bool make_space(IntDict *const dict)
 {
-  DEBUGF("Insert key %" PRIIntDictKey
-         " with value %p in dictionary %p of size %zu\n",
-         key, value, (void *)dict, dict->nitems);
+  /* Ensure that there is space for at least one more item */
   assert(dict);
   assert(dict->nitems <= dict->nalloc);
 
-  size_t const ins_index = intdict_bisect_left(dict, key);
-  size_t const nitems = dict->nitems;
+  if (dict->nitems < dict->nalloc) {
+    return true;
+  }
 
-  if (nitems == dict->nalloc) {
-    if (dict->nalloc == SIZE_MAX) {
-      DEBUGF("Can't reallocate dictionary at max size\n");
-      return false;
+  if (dict->offset > 0 &&
+      dict->offset >= dict->nitems / ArrayReclaimDivisor) {
+    /* Enough items were removed from the head, relative to the number that
+       remain, for the cost of moving the remaining items to be amortized
+       over the removals. */
+    DEBUGF("Reclaiming %zu unused items\n", dict->offset);
+    IntDictItem *const base = get_base(dict);
+    memmove(base, dict->array, dict->nitems * sizeof(*base));
+    dict->array = base;
+    if (dict->sums) {
+      unsigned long long *const sums_base = get_sums_base(dict);
+      memmove(sums_base, dict->sums, dict->nitems * sizeof(*sums_base));
+      dict->sums = sums_base;
     }
+    dict->nalloc += dict->offset;
+    dict->offset = 0;
+    dict->candidate = NULL;
+    return true;
+  }
 
-    size_t new_size = ArrayInitSize;
-    if (dict->nalloc > 0) {
-      if (dict->nalloc < SIZE_MAX / ArrayGrowthFactor) {
-        new_size = dict->nalloc * ArrayGrowthFactor;
-      } else {
-        new_size = SIZE_MAX;
-      }
+  size_t const old_size = dict->nalloc + dict->offset;
+  if (old_size == SIZE_MAX) {
+    DEBUGF("Can't reallocate dictionary at max size\n");
+    return false;
+  }
+
+  size_t new_size = ArrayInitSize;
+  if (old_size > 0) {
+    if (old_size < SIZE_MAX / ArrayGrowthFactor) {
+      new_size = old_size * ArrayGrowthFactor;
+    } else {
+      new_size = SIZE_MAX;
     }
+  }
+
+  DEBUGF("Reallocating dictionary from %zu to %zu items\n", old_size,
+         new_size);
+  IntDictItem *const new_array = realloc(
+    get_base(dict), new_size * sizeof(*new_array));
+
+  if (!new_array) {
+    DEBUGF("Memory allocation failure\n");
+    return false;
+  }
+  dict->array = new_array + dict->offset;
+  dict->candidate = NULL;
 
-    DEBUGF("Reallocating dictionary from %zu to %zu items\n", dict->nalloc,
-           new_size);
-    IntDictItem *const new_array = realloc(
-      dict->array, new_size * sizeof(*new_array));
+  if (dict->sums) {
+    /* The capacity isn't updated unless both arrays were reallocated */
+    unsigned long long *const new_sums = realloc(
+      get_sums_base(dict), new_size * sizeof(*new_sums));
 
-    if (!new_array) {
+    if (!new_sums) {
       DEBUGF("Memory allocation failure\n");
       return false;
     }
-    dict->nalloc = new_size;
-    dict->array = new_array;
+    dict->sums = new_sums + dict->offset;
+  }
+
+  dict->nalloc = new_size - dict->offset;
+  return true;
+}
+
+bool intdict_insert(IntDict *const dict, IntDictKey const key,
+                    void *const value, size_t *const index)
+{
+  DEBUGF("Insert key %" PRIIntDictKey
+         " with value %p in dictionary %p of size %zu\n",
+         key, value, (void *)dict, dict->nitems);
+  assert(dict);
+  assert(dict->nitems <= dict->nalloc);
+
+  size_t const nitems = dict->nitems;
+  size_t ins_index = nitems;
+
+  /* Keys often arrive in ascending order, in which case there is no need
+     to search for the insertion point. */
+  if (nitems > 0 && dict->array[nitems - 1].key >= key) {
+    ins_index = intdict_bisect_left(dict, key);
+  } else {
+    DEBUGF("Key %" PRIIntDictKey " belongs at the end\n", key);
+  }
+
+  if (!make_space(dict)) {
+    return false;
   }
 
   DEBUGF("Inserting item with key %" PRIIntDictKey ", value %p at %zu\n",
@@ -233,6 +362,17 @@ bool intdict_insert(IntDict *const dict, IntDictKey const key,
     dict->array[i] = dict->array[i - 1];
   }
 
+  if (dict->sums) {
+    /* The sum of the keys before the insertion point is unchanged */
+    for (size_t i = nitems; i > ins_index; --i) {
+      dict->sums[i] = dict->sums[i - 1] + (unsigned long long)key;
+    }
+    if (ins_index == nitems) {
+      dict->sums[ins_index] = dict->sum_total;
+    }
+    dict->sum_total += (unsigned long long)key;
+  }
+
   assert(ins_index < dict->nalloc);
   dict->array[ins_index] = (IntDictItem){.key = key, .value = value};
 
@@ -257,6 +397,116 @@ bool intdict_insert(IntDict *const dict, IntDictKey const key,
   return true;
 }
 
+bool intdict_append(IntDict *const dict, IntDictKey const key,
+                    void *const value)
+{
+  DEBUGF("Append key %" PRIIntDictKey
+         " with value %p to dictionary %p of size %zu\n",
+         key, value, (void *)dict, dict->nitems);
+  assert(dict);
+  assert(dict->nitems <= dict->nalloc);
+  assert(dict->nitems == 0 || dict->array[dict->nitems - 1].key <= key);
+
+  if (!make_space(dict)) {
+    return false;
+  }
+
+  assert(dict->nitems < dict->nalloc);
+  if (dict->sums) {
+    dict->sums[dict->nitems] = dict->sum_total;
+    dict->sum_total += (unsigned long long)key;
+  }
+  dict->array[dict->nitems++] = (IntDictItem){.key = key, .value = value};
+  return true;
+}
+
+bool intdict_index_sums(IntDict *const dict)
+{
+  DEBUGF("Indexing sums of keys in dictionary %p of size %zu\n",
+         (void *)dict, dict->nitems);
+  assert(dict);
+  assert(dict->nitems <= dict->nalloc);
+
+  if (dict->sums) {
+    return true;
+  }
+
+  if (dict->nalloc + dict->offset == 0 && !make_space(dict)) {
+    return false;
+  }
+
+  size_t const size = dict->nalloc + dict->offset;
+  unsigned long long *const sums = malloc(size * sizeof(*sums));
+  if (!sums) {
+    DEBUGF("Memory allocation failure\n");
+    return false;
+  }
+
+  dict->sums = sums + dict->offset;
+  dict->sum_total = 0;
+  for (size_t i = 0; i < dict->nitems; ++i) {
+    dict->sums[i] = dict->sum_total;
+    dict->sum_total += (unsigned long long)dict->array[i].key;
+  }
+  return true;
+}
+
+long long intdict_sum_range(IntDict *const dict, IntDictKey const min_key,
+                            IntDictKey const max_key)
+{
+  assert(dict);
+  assert(dict->nitems <= dict->nalloc);
+
+  if (min_key > max_key) {
+    return 0;
+  }
+
+  size_t const start = intdict_bisect_left(dict, min_key),
+               end = intdict_bisect_right(dict, max_key);
+  unsigned long long sum = 0;
+
+  if (start < end) {
+    if (dict->sums) {
+      sum = (end < dict->nitems ? dict->sums[end] : dict->sum_total) -
+            dict->sums[start];
+    } else {
+      for (size_t i = start; i < end; ++i) {
+        sum += (unsigned long long)dict->array[i].key;
+      }
+    }
+  }
+
+  DEBUGF("Sum of %zu keys in range %" PRIIntDictKey "..%" PRIIntDictKey
+         " is %llu\n", end - start, min_key, max_key, sum);
+
+  /* Modular arithmetic gives the right result if it is representable */
+  return sum > LLONG_MAX ? -(long long)(0ull - sum) : (long long)sum;
+}
+
+IntDictKey intdict_quantile(IntDict const *const dict, double const fraction)
+{
+  assert(dict);
+  assert(dict->nitems > 0);
+  assert(fraction >= 0.0);
+  assert(fraction <= 1.0);
+
+  /* Nearest-rank method: the smallest key such that at least the given
+     fraction of keys are less than or equal to it. */
+  double const rank = fraction * (double)dict->nitems;
+  size_t index = (size_t)rank;
+  if ((double)index < rank) {
+    ++index; /* round up */
+  }
+  index = index > 0 ? index - 1 : 0;
+  if (index >= dict->nitems) {
+    index = dict->nitems - 1;
+  }
+
+  DEBUGF("Quantile %g of dictionary %p is at index %zu\n", fraction,
+         (void *)dict, index);
+  return dict->array[index].key;
+}
+
 size_t intdict_bisect_left(IntDict *const dict, IntDictKey const key)
 {
   assert(dict);
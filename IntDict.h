@@ -31,6 +31,12 @@
                   Added the intdict_find_specific function.
                   intdictviter_remove now returns the removed item's index.
   CJB: 29-Aug-22: Commented out the last intdictviter_init parameter name.
+  CJB: 17-Oct-26: Added a dictionary type that stores values of a size
+                  specified at initialization time alongside the keys.
+                  Added the intdict_append function.
+                  Added the intdict_remove_head function.
+                  Added rank, quantile and range sum queries.
+                  Added the intdict_parallel_for_range function.
  */
 
 #ifndef IntDict_h
@@ -41,6 +47,8 @@
 #include <limits.h>
 #include <assert.h>
 
+#include "ThreadPool.h"
+
 typedef long int IntDictKey;
 #define INTDICTKEY_MIN LONG_MIN
 #define INTDICTKEY_MAX LONG_MAX
@@ -54,6 +62,9 @@ typedef struct IntDictItem {
 typedef struct {
   size_t nalloc;
   size_t nitems;
+  size_t offset;
+  unsigned long long *sums;
+  unsigned long long sum_total;
   IntDictKey sought_key;
   IntDictItem *array;
   IntDictItem const *candidate;
@@ -110,10 +121,24 @@ bool intdict_insert(IntDict */*dict*/, IntDictKey /*key*/, void */*value*/,
     * Insert an item and value pair into an integer dictionary. If the new
     * item's key is not unique then its position is indeterminate relative
     * to any items with equal keys that were already in the dictionary.
+    * Inserting an item with a key greater than all those already in the
+    * dictionary does not require a search.
     * Outputs the index of the inserted item if successful.
     * Returns: true if successful, otherwise false (out of memory).
     */
 
+bool intdict_append(IntDict */*dict*/, IntDictKey /*key*/,
+                    void */*value*/);
+   /*
+    * Append an item and value pair to an integer dictionary. The new item's
+    * key must not be less than any key already in the dictionary. Unlike
+    * intdict_insert, this doesn't compare the key with other keys (except
+    * to check the precondition in debug builds), so a dictionary can be
+    * built from sorted input in linear time. The index of the appended
+    * item is one less than the new count of items.
+    * Returns: true if successful, otherwise false (out of memory).
+    */
+
 static inline size_t intdict_count(IntDict const *const dict)
 {
   assert(dict);
@@ -154,6 +179,17 @@ static inline void *intdict_get_value_at(IntDict const *const dict,
 void intdict_remove_at(IntDict */*dict*/, size_t /*index*/);
    /*
     * Remove the item currently at a given index from an integer dictionary.
+    * Removing the item at index 0 takes constant time.
+    */
+
+void intdict_remove_head(IntDict */*dict*/, size_t /*count*/);
+   /*
+    * Remove a given number of items from the head of an integer dictionary
+    * (i.e. those with the lowest keys) in constant time. The space that they
+    * occupied is reclaimed when the dictionary next needs to grow. This is
+    * intended for dictionaries used as a sliding window, e.g. to expire all
+    * keys less than a given key by passing the result of
+    * intdict_bisect_left as the count.
     */
 
 void *intdict_remove_value_at(IntDict */*dict*/, size_t /*index*/);
@@ -185,6 +221,63 @@ size_t intdict_bisect_right(IntDict */*dict*/, IntDictKey /*key*/);
     *          keys can be found.
     */
 
+static inline size_t intdict_rank(IntDict *const dict, IntDictKey const key)
+{
+  return intdict_bisect_left(dict, key);
+}
+   /*
+    * Get the rank of a key in an integer dictionary, which is the number of
+    * items with lower keys. The key need not be in the dictionary.
+    * Returns: the number of items with keys less than the given key.
+    */
+
+static inline size_t intdict_count_range(IntDict *const dict,
+                                         IntDictKey const min_key,
+                                         IntDictKey const max_key)
+{
+  if (min_key > max_key) {
+    return 0;
+  }
+  size_t const start = intdict_bisect_left(dict, min_key);
+  return intdict_bisect_right(dict, max_key) - start;
+}
+   /*
+    * Count the items in an integer dictionary with keys in a given range.
+    * 'min_key' and 'max_key' are inclusive bounds.
+    * Returns: the number of items with keys in the given range.
+    */
+
+IntDictKey intdict_quantile(IntDict const */*dict*/, double /*fraction*/);
+   /*
+    * Get the smallest key in a non-empty integer dictionary such that at
+    * least the given fraction (0.0 to 1.0) of all keys are less than or
+    * equal to it. For example, a fraction of 0.99 gives the 99th
+    * percentile using the nearest-rank method.
+    * Returns: the key at the given quantile.
+    */
+
+bool intdict_index_sums(IntDict */*dict*/);
+   /*
+    * Create an index of the cumulative sums of the keys in an integer
+    * dictionary, so that intdict_sum_range takes logarithmic instead of
+    * linear time. The index is updated whenever an item is inserted or
+    * removed, which adds to the cost of inserting and removing items
+    * other than at the head or tail of the dictionary. It is destroyed
+    * with the dictionary. Calling this function again has no effect.
+    * Returns: true if successful, otherwise false (out of memory).
+    */
+
+long long intdict_sum_range(IntDict */*dict*/, IntDictKey /*min_key*/,
+                            IntDictKey /*max_key*/);
+   /*
+    * Sum the keys of all items in an integer dictionary with keys in a
+    * given range. 'min_key' and 'max_key' are inclusive bounds. Together
+    * with intdict_count_range, this can be used to compute the mean. The
+    * result is only correct if it is representable as a long long; the
+    * intermediate sums may overflow without affecting it.
+    * Returns: the sum of the keys in the given range (0 if none).
+    */
+
 static inline void *intdict_find_value(IntDict *const dict,
                                        IntDictKey const key,
                                        size_t *const index)
@@ -295,6 +388,29 @@ static inline bool intdict_remove_specific(IntDict *dict,
     * of the loop and points to the current item.
     */
 
+static inline bool intdict_parallel_for_range(IntDict *const dict,
+  IntDictKey const min_key, IntDictKey const max_key, ThreadPool *const pool,
+  ThreadPoolRangeFn *const fn, void *const arg,
+  ThreadPoolReduction const *const reduction)
+{
+  size_t const start = intdict_bisect_left(dict, min_key);
+  size_t const end = intdict_bisect_right(dict, max_key);
+  return threadpool_for(pool, start, end > start ? end : start, fn, arg,
+                        reduction);
+}
+   /*
+    * Process a range of keys within an integer dictionary in parallel by
+    * splitting the range of indices into chunks and calling 'fn' for each
+    * chunk using the threads of a pool, as for threadpool_for. 'min_key'
+    * and 'max_key' are inclusive bounds. The dictionary must not be
+    * modified until this function returns. The callback function may get
+    * the keys and values at indices within its chunk but must not call
+    * functions that search the dictionary because they are not safe to
+    * call concurrently.
+    * Returns: true if successful, otherwise false (out of memory for
+    *          partial results).
+    */
+
 typedef struct {
   IntDict *dict;
   size_t next_index, end;
@@ -342,4 +458,182 @@ size_t intdictviter_remove(IntDictVIter */*iter*/);
     * Returns: the former index of the removed item.
     */
 
+typedef struct {
+  size_t nalloc;
+  size_t nitems;
+  size_t value_size;
+  size_t value_offset;
+  size_t item_size;
+  unsigned char *array;
+} IntValDict;
+   /*
+    * An integer dictionary type that associates every item in an ordered
+    * list of integers (keys) with a value of fixed size. Unlike IntDict,
+    * each value is copied into the same array as its key, so that no
+    * separate object needs to be allocated per value. Duplicate keys are
+    * allowed unless the client explicitly takes steps to prevent them.
+    */
+
+void intvaldict_init(IntValDict */*dict*/, size_t /*value_size*/);
+   /*
+    * Initialize an integer dictionary in which each value is 'value_size'
+    * bytes long. Values are stored with suitable alignment for any type
+    * of that size.
+    */
+
+void intvaldict_destroy(IntValDict */*dict*/,
+                        IntDictDestructorFn */*destructor*/, void */*arg*/);
+   /*
+    * Destroy an integer dictionary, optionally calling a destructor function
+    * (if the callback function pointer is not null). The 'value' passed to
+    * the destructor points to the value stored in the dictionary.
+    */
+
+bool intvaldict_find(IntValDict const */*dict*/, IntDictKey /*key*/,
+                     size_t */*index*/);
+   /*
+    * Search for the first item with a given key in an integer dictionary.
+    * Outputs the index of the item if the dictionary contains the key.
+    * Indices are not guaranteed to remain valid after inserting or
+    * removing items.
+    * Returns: true if the dictionary contains the key, otherwise false.
+    */
+
+bool intvaldict_insert(IntValDict */*dict*/, IntDictKey /*key*/,
+                       void const */*value*/, size_t */*index*/);
+   /*
+    * Insert an item into an integer dictionary, copying the value from the
+    * object pointed to by 'value'. If 'value' is a null pointer then the
+    * stored value is left uninitialized for the client to fill in (e.g.
+    * by calling intvaldict_get_value_at with the output index). The new
+    * item is inserted after any items with equal keys.
+    * Outputs the index of the inserted item if successful.
+    * Returns: true if successful, otherwise false (out of memory).
+    */
+
+void intvaldict_remove_at(IntValDict */*dict*/, size_t /*index*/);
+   /*
+    * Remove the item currently at a given index from an integer dictionary.
+    */
+
+size_t intvaldict_bisect_left(IntValDict const */*dict*/,
+                              IntDictKey /*key*/);
+   /*
+    * Search in an integer dictionary for the lowest key not less than a
+    * specified key. Equivalent to intdict_bisect_left.
+    * Returns: the (inclusive) position beyond which all items with equal
+    *          or higher keys can be found.
+    */
+
+size_t intvaldict_bisect_right(IntValDict const */*dict*/,
+                               IntDictKey /*key*/);
+   /*
+    * Search in an integer dictionary for the lowest key greater than a
+    * specified key. Equivalent to intdict_bisect_right.
+    * Returns: the (exclusive) position before which all items with lower
+    *          keys can be found.
+    */
+
+static inline size_t intvaldict_count(IntValDict const *const dict)
+{
+  assert(dict);
+  assert(dict->nitems <= dict->nalloc);
+  return dict->nitems;
+}
+   /*
+    * Count the number of items in an integer dictionary.
+    * Returns: number of items.
+    */
+
+static inline IntDictKey intvaldict_get_key_at(IntValDict const *const dict,
+                                               size_t const index)
+{
+  assert(dict);
+  assert(dict->nitems <= dict->nalloc);
+  assert(index < dict->nitems);
+  return *(IntDictKey const *)(void const *)
+           (dict->array + (index * dict->item_size));
+}
+   /*
+    * Get the key currently at a given index in an integer dictionary.
+    * Returns: the key with the given index.
+    */
+
+static inline void *intvaldict_get_value_at(IntValDict const *const dict,
+                                            size_t const index)
+{
+  assert(dict);
+  assert(dict->nitems <= dict->nalloc);
+  assert(index < dict->nitems);
+  return dict->array + (index * dict->item_size) + dict->value_offset;
+}
+   /*
+    * Get the value currently at a given index in an integer dictionary.
+    * The value can be modified in place. The pointer is not guaranteed to
+    * remain valid after inserting or removing items.
+    * Returns: pointer to the value with the given index.
+    */
+
+static inline void *intvaldict_find_value(IntValDict const *const dict,
+                                          IntDictKey const key,
+                                          size_t *const index)
+{
+  size_t pos;
+  if (!intvaldict_find(dict, key, &pos)) {
+    return NULL;
+  }
+  if (index) {
+    *index = pos;
+  }
+  return intvaldict_get_value_at(dict, pos);
+}
+   /*
+    * Search for the first item with a given key in an integer dictionary.
+    * Outputs the index of the item if the dictionary contains the key.
+    * Returns: pointer to the value associated with the given key, or NULL
+    *          if the key was not found.
+    */
+
+static inline bool intvaldict_remove(IntValDict *const dict,
+                                     IntDictKey const key,
+                                     size_t *const index)
+{
+  size_t pos;
+  if (!intvaldict_find(dict, key, &pos)) {
+    return false;
+  }
+  intvaldict_remove_at(dict, pos);
+  if (index) {
+    *index = pos;
+  }
+  return true;
+}
+   /*
+    * Remove an item with a given key from an integer dictionary. If the
+    * specified key is not unique then the first item with that key is
+    * removed. Outputs the former position of the removed item if
+    * successful.
+    * Returns: true if the dictionary contained the key, otherwise false.
+    */
+
+#define INTVALDICT_FOR_EACH(dict, index, tmp) \
+  for (size_t (index) = 0, (tmp) = intvaldict_count(dict); \
+       (index) < (tmp); \
+       ++(index))
+   /*
+    * Macro to be used for iterating over an integer dictionary of the type
+    * that stores values alongside keys. Equivalent to INTDICT_FOR_EACH.
+    */
+
+#define INTVALDICT_FOR_EACH_IN_RANGE(dict, min_key, max_key, index, tmp) \
+  for (size_t (index) = intvaldict_bisect_left((dict), (min_key)), \
+         (tmp) = intvaldict_bisect_right((dict), (max_key)); \
+       (index) < (tmp); \
+       ++(index))
+   /*
+    * Macro to be used for iterating over a range of keys within an integer
+    * dictionary of the type that stores values alongside keys. Equivalent
+    * to INTDICT_FOR_EACH_IN_RANGE.
+    */
+
 #endif
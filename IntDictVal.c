@@ -0,0 +1,248 @@
+/*
+ * CBUtilLib: Integer dictionary with values stored alongside keys
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* History:
+  CJB: 17-Oct-26: Created this source file.
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "IntDict.h"
+#include "Internal/CBUtilMisc.h"
+
+enum {
+  ArrayInitSize = 4,
+  ArrayGrowthFactor = 2,
+};
+
+/* Types used to find the strictest alignment that a value might need */
+typedef union {
+  long double ld;
+  double d;
+  long long ll;
+  void *p;
+  void (*fp)(void);
+} MaxAlign;
+
+struct KeyAlign { char c; IntDictKey key; };
+struct ValueAlign { char c; MaxAlign value; };
+
+static size_t round_up(size_t const size, size_t const align)
+{
+  assert(align > 0);
+  return ((size + align - 1) / align) * align;
+}
+
+static size_t value_align(size_t const value_size)
+{
+  /* An object's size is always a multiple of its alignment, so the lowest
+     set bit of the size is enough unless it exceeds the strictest
+     alignment of any type. */
+  size_t const max_align = offsetof(struct ValueAlign, value);
+  if (value_size == 0) {
+    return 1;
+  }
+  return LOWEST(value_size & (~value_size + 1), max_align);
+}
+
+static unsigned char *item_at(IntValDict const *const dict,
+                              size_t const index)
+{
+  assert(dict);
+  assert(index < dict->nalloc);
+  return dict->array + (index * dict->item_size);
+}
+
+void intvaldict_init(IntValDict *const dict, size_t const value_size)
+{
+  DEBUGF("Initializing integer dictionary %p with values of size %zu\n",
+         (void *)dict, value_size);
+  assert(dict);
+
+  size_t const key_align = offsetof(struct KeyAlign, key);
+  size_t const val_align = value_align(value_size);
+  size_t const value_offset = round_up(sizeof(IntDictKey), val_align);
+
+  *dict = (IntValDict){
+    .value_size = value_size,
+    .value_offset = value_offset,
+    .item_size = round_up(value_offset + value_size,
+                          HIGHEST(key_align, val_align)),
+  };
+
+  DEBUGF("Values are at offset %zu in items of size %zu\n",
+         dict->value_offset, dict->item_size);
+}
+
+void intvaldict_destroy(IntValDict *const dict,
+  IntDictDestructorFn *const destructor, void *const arg)
+{
+  DEBUGF("Terminating integer dictionary %p\n", (void *)dict);
+  assert(dict);
+  assert(dict->nitems <= dict->nalloc);
+
+  if (destructor) {
+    size_t const nitems = dict->nitems;
+    for (size_t i = 0; i < nitems; ++i) {
+      destructor(intvaldict_get_key_at(dict, i),
+                 intvaldict_get_value_at(dict, i), arg);
+      assert(nitems == dict->nitems);
+    }
+  }
+
+  free(dict->array);
+}
+
+void intvaldict_remove_at(IntValDict *const dict, size_t const index)
+{
+  assert(dict);
+  assert(dict->nitems <= dict->nalloc);
+  assert(index < dict->nitems);
+
+  DEBUGF("Removing item with key %" PRIIntDictKey
+         " at position %zu in dictionary %p of size %zu\n",
+         intvaldict_get_key_at(dict, index), index, (void *)dict,
+         dict->nitems);
+
+  dict->nitems--;
+  memmove(item_at(dict, index), item_at(dict, index) + dict->item_size,
+          (dict->nitems - index) * dict->item_size);
+}
+
+bool intvaldict_find(IntValDict const *const dict, IntDictKey const key,
+  size_t *const pos)
+{
+  size_t const index = intvaldict_bisect_left(dict, key);
+  if (index >= dict->nitems || intvaldict_get_key_at(dict, index) != key) {
+    DEBUGF("Can't find key %" PRIIntDictKey "\n", key);
+    return false;
+  }
+
+  DEBUGF("Found key %" PRIIntDictKey " at index %zu\n", key, index);
+  if (pos) {
+    *pos = index;
+  }
+  return true;
+}
+
+bool intvaldict_insert(IntValDict *const dict, IntDictKey const key,
+                       void const *const value, size_t *const index)
+{
+  DEBUGF("Insert key %" PRIIntDictKey
+         " with value %p in dictionary %p of size %zu\n",
+         key, value, (void *)dict, dict->nitems);
+  assert(dict);
+  assert(dict->nitems <= dict->nalloc);
+
+  size_t const nitems = dict->nitems;
+
+  if (nitems == dict->nalloc) {
+    size_t new_size = ArrayInitSize;
+    if (dict->nalloc > 0) {
+      if (dict->nalloc > SIZE_MAX / ArrayGrowthFactor / dict->item_size) {
+        DEBUGF("Can't reallocate dictionary at max size\n");
+        return false;
+      }
+      new_size = dict->nalloc * ArrayGrowthFactor;
+    }
+
+    DEBUGF("Reallocating dictionary from %zu to %zu items\n", dict->nalloc,
+           new_size);
+    unsigned char *const new_array = realloc(dict->array,
+                                             new_size * dict->item_size);
+    if (!new_array) {
+      DEBUGF("Memory allocation failure\n");
+      return false;
+    }
+    dict->nalloc = new_size;
+    dict->array = new_array;
+  }
+
+  size_t const ins_index = intvaldict_bisect_right(dict, key);
+  DEBUGF("Inserting item with key %" PRIIntDictKey " at %zu\n",
+         key, ins_index);
+
+  unsigned char *const item = item_at(dict, ins_index);
+  memmove(item + dict->item_size, item,
+          (nitems - ins_index) * dict->item_size);
+
+  *(IntDictKey *)(void *)item = key;
+  if (value) {
+    memcpy(item + dict->value_offset, value, dict->value_size);
+  }
+
+  assert(dict->nitems < dict->nalloc);
+  dict->nitems++;
+
+#ifndef NDEBUG
+  for (size_t i = 1; i < dict->nitems; ++i) {
+    assert(intvaldict_get_key_at(dict, i - 1) <=
+           intvaldict_get_key_at(dict, i));
+  }
+#endif
+
+  if (index) {
+    *index = ins_index;
+  }
+  return true;
+}
+
+size_t intvaldict_bisect_left(IntValDict const *const dict,
+                              IntDictKey const key)
+{
+  assert(dict);
+  assert(dict->nitems <= dict->nalloc);
+
+  size_t low = 0, high = dict->nitems;
+  while (low < high) {
+    size_t const mid = low + ((high - low) / 2);
+    if (intvaldict_get_key_at(dict, mid) < key) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+
+  DEBUGF("Key %" PRIIntDictKey " belongs at position %zu\n", key, low);
+  return low;
+}
+
+size_t intvaldict_bisect_right(IntValDict const *const dict,
+                               IntDictKey const key)
+{
+  assert(dict);
+  assert(dict->nitems <= dict->nalloc);
+
+  size_t low = 0, high = dict->nitems;
+  while (low < high) {
+    size_t const mid = low + ((high - low) / 2);
+    if (intvaldict_get_key_at(dict, mid) <= key) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+
+  DEBUGF("Lowest key > %" PRIIntDictKey " is at position %zu\n", key, low);
+  return low;
+}
@@ -0,0 +1,42 @@
+/*
+ * CBUtilLib: Macros for examining a machine word at a time
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef WordScan_h
+#define WordScan_h
+
+/* ISO library headers */
+#include <limits.h>
+
+/* Words should be copied into a local variable (e.g. using memcpy) rather
+   than loaded through a cast pointer, to avoid alignment and aliasing
+   problems. */
+typedef unsigned long Word;
+
+/* A word with the least significant bit of every byte set, and a word with
+   the most significant bit of every byte set. */
+#define ONES (ULONG_MAX / UCHAR_MAX)
+#define HIGHS (ONES * (UCHAR_MAX / 2 + 1))
+
+/* Non-zero if any byte of a word is zero */
+#define HAS_ZERO_BYTE(w) (((w) - ONES) & ~(w) & HIGHS)
+
+/* Non-zero if any byte of a word equals a given character */
+#define HAS_BYTE(w, c) HAS_ZERO_BYTE((w) ^ (ONES * (unsigned char)(c)))
+
+#endif /* WordScan_h */
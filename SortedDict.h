@@ -0,0 +1,262 @@
+/*
+ * CBUtilLib: Type-specialised sorted dictionary generator
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* SortedDict.h defines a macro that generates a dictionary type, and
+   inline functions to manipulate it, for a given key type and value type.
+   Unlike IntDict and StrDict, the generated dictionary stores values in
+   the same array as the keys, and compares keys without calling back
+   through a function pointer.
+
+Dependencies: ANSI C library.
+Message tokens: None
+History:
+  CJB: 17-Oct-26: Created this header file.
+*/
+
+#ifndef SortedDict_h
+#define SortedDict_h
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+
+#define SORTEDDICT_INIT_SIZE 4
+#define SORTEDDICT_GROWTH_FACTOR 2
+
+#define SORTEDDICT_DEFINE(name, KeyT, ValueT, cmp) \
+\
+typedef struct { \
+  KeyT key; \
+  ValueT value; \
+} name##Item; \
+\
+typedef struct { \
+  size_t nalloc; \
+  size_t nitems; \
+  name##Item *array; \
+} name; \
+\
+static inline void name##_init(name *const dict) \
+{ \
+  assert(dict); \
+  *dict = (name){0}; \
+} \
+\
+static inline void name##_destroy(name *const dict) \
+{ \
+  assert(dict); \
+  assert(dict->nitems <= dict->nalloc); \
+  free(dict->array); \
+} \
+\
+static inline size_t name##_count(name const *const dict) \
+{ \
+  assert(dict); \
+  assert(dict->nitems <= dict->nalloc); \
+  return dict->nitems; \
+} \
+\
+static inline KeyT name##_get_key_at(name const *const dict, \
+                                     size_t const index) \
+{ \
+  assert(dict); \
+  assert(index < dict->nitems); \
+  return dict->array[index].key; \
+} \
+\
+static inline ValueT *name##_get_value_at(name const *const dict, \
+                                          size_t const index) \
+{ \
+  assert(dict); \
+  assert(index < dict->nitems); \
+  return &dict->array[index].value; \
+} \
+\
+static inline size_t name##_bisect_left(name const *const dict, \
+                                        KeyT const key) \
+{ \
+  assert(dict); \
+  assert(dict->nitems <= dict->nalloc); \
+  size_t low = 0, high = dict->nitems; \
+  while (low < high) { \
+    size_t const mid = low + ((high - low) / 2); \
+    if (cmp(dict->array[mid].key, key) < 0) { \
+      low = mid + 1; \
+    } else { \
+      high = mid; \
+    } \
+  } \
+  return low; \
+} \
+\
+static inline size_t name##_bisect_right(name const *const dict, \
+                                         KeyT const key) \
+{ \
+  assert(dict); \
+  assert(dict->nitems <= dict->nalloc); \
+  size_t low = 0, high = dict->nitems; \
+  while (low < high) { \
+    size_t const mid = low + ((high - low) / 2); \
+    if (cmp(key, dict->array[mid].key) < 0) { \
+      high = mid; \
+    } else { \
+      low = mid + 1; \
+    } \
+  } \
+  return low; \
+} \
+\
+static inline bool name##_find(name const *const dict, KeyT const key, \
+                               size_t *const index) \
+{ \
+  size_t const pos = name##_bisect_left(dict, key); \
+  if (pos >= dict->nitems || cmp(dict->array[pos].key, key) != 0) { \
+    return false; \
+  } \
+  if (index) { \
+    *index = pos; \
+  } \
+  return true; \
+} \
+\
+static inline ValueT *name##_find_value(name const *const dict, \
+                                        KeyT const key, \
+                                        size_t *const index) \
+{ \
+  size_t pos; \
+  if (!name##_find(dict, key, &pos)) { \
+    return NULL; \
+  } \
+  if (index) { \
+    *index = pos; \
+  } \
+  return &dict->array[pos].value; \
+} \
+\
+static inline bool name##_insert(name *const dict, KeyT const key, \
+                                 ValueT const value, size_t *const index) \
+{ \
+  assert(dict); \
+  assert(dict->nitems <= dict->nalloc); \
+  if (dict->nitems == dict->nalloc) { \
+    size_t new_size = SORTEDDICT_INIT_SIZE; \
+    if (dict->nalloc > 0) { \
+      if (dict->nalloc > SIZE_MAX / SORTEDDICT_GROWTH_FACTOR / \
+                         sizeof(*dict->array)) { \
+        return false; \
+      } \
+      new_size = dict->nalloc * SORTEDDICT_GROWTH_FACTOR; \
+    } \
+    name##Item *const new_array = realloc(dict->array, \
+                                          new_size * sizeof(*new_array)); \
+    if (!new_array) { \
+      return false; \
+    } \
+    dict->nalloc = new_size; \
+    dict->array = new_array; \
+  } \
+  size_t const ins_index = name##_bisect_right(dict, key); \
+  memmove(dict->array + ins_index + 1, dict->array + ins_index, \
+          (dict->nitems - ins_index) * sizeof(*dict->array)); \
+  dict->array[ins_index].key = key; \
+  dict->array[ins_index].value = value; \
+  dict->nitems++; \
+  if (index) { \
+    *index = ins_index; \
+  } \
+  return true; \
+} \
+\
+static inline void name##_remove_at(name *const dict, size_t const index) \
+{ \
+  assert(dict); \
+  assert(index < dict->nitems); \
+  dict->nitems--; \
+  memmove(dict->array + index, dict->array + index + 1, \
+          (dict->nitems - index) * sizeof(*dict->array)); \
+} \
+\
+static inline bool name##_remove(name *const dict, KeyT const key, \
+                                 size_t *const index) \
+{ \
+  size_t pos; \
+  if (!name##_find(dict, key, &pos)) { \
+    return false; \
+  } \
+  name##_remove_at(dict, pos); \
+  if (index) { \
+    *index = pos; \
+  } \
+  return true; \
+}
+   /*
+    * Macro to define a dictionary type named 'name' that associates every
+    * item in an ordered list of keys of type 'KeyT' with a value of type
+    * 'ValueT'. Each value is copied into the dictionary's array alongside
+    * its key. Duplicate keys are allowed unless the client explicitly takes
+    * steps to prevent them.
+    *
+    * 'cmp' must be a function or function-like macro that takes two keys
+    * and returns an integer less than, equal to or greater than zero if the
+    * first key is less than, equal to or greater than the second key. It is
+    * called directly (not through a pointer) so that it can be inlined.
+    *
+    * The following functions are defined, with the same meanings as the
+    * equivalent IntDict functions except as noted:
+    *   name_init, name_destroy, name_count, name_get_key_at,
+    *   name_get_value_at, name_bisect_left, name_bisect_right, name_find,
+    *   name_find_value, name_insert, name_remove_at and name_remove.
+    *
+    * name_get_value_at and name_find_value return a pointer to the value
+    * stored in the dictionary, which remains valid until an item is
+    * inserted or removed. name_insert inserts a new item after any items
+    * with an equal key. name_destroy does not destroy the values; use
+    * SORTEDDICT_FOR_EACH to do that first if required.
+    */
+
+#define SORTEDDICT_FOR_EACH(name, dict, index, tmp) \
+  for (size_t (index) = 0, (tmp) = name##_count(dict); \
+       (index) < (tmp); \
+       ++(index))
+   /*
+    * Macro to be used for iterating over a dictionary of the type named
+    * 'name'. The dictionary must not be modified within the body of the
+    * loop. Indices are generated in sorted key order. 'index' has the same
+    * scope as the body of the loop and points to the current item.
+    */
+
+#define SORTEDDICT_FOR_EACH_IN_RANGE(name, dict, min_key, max_key, index, \
+                                     tmp) \
+  for (size_t (index) = name##_bisect_left((dict), (min_key)), \
+         (tmp) = name##_bisect_right((dict), (max_key)); \
+       (index) < (tmp); \
+       ++(index))
+   /*
+    * Macro to be used for iterating over a range of keys within a
+    * dictionary of the type named 'name'. The dictionary must not be
+    * modified within the body of the loop. 'min_key' and 'max_key' are
+    * inclusive bounds. Indices are generated in sorted key order. 'index'
+    * has the same scope as the body of the loop and points to the current
+    * item.
+    */
+
+#endif
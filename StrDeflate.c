@@ -0,0 +1,322 @@
+/*
+ * CBUtilLib: Deflate a string by replacing certain substrings with strings
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* History:
+  CJB: 17-Oct-26: Created this source file.
+                  Copy the array of pointers to replacement strings.
+*/
+
+/* ISO library headers */
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdint.h>
+
+/* Local headers */
+#include "StrExtra.h"
+#include "Internal/CBUtilMisc.h"
+
+/* The search strings are matched by an Aho-Corasick automaton. Characters
+   that do not occur in any search string are mapped to class 0 and every
+   other character to its own class, so that the transition table can be
+   complete (no failure links to follow at run time) yet small. */
+
+enum
+{
+  RootState = 0,
+  NoMatch = 0,
+};
+
+struct StrDeflater
+{
+  size_t       nclasses;
+  size_t       nstates;
+  size_t      *next;      /* Next state for each state and class */
+  size_t      *match;     /* 1 + index of the longest search string ending
+                             in each state, or NoMatch */
+  size_t      *srch_len;  /* Length of each search string */
+  size_t      *rplc_len;  /* Length of each replacement string */
+  const char **rplc;      /* Copy of the pointers to replacement
+                             strings */
+  unsigned char cls[UCHAR_MAX + 1];
+};
+
+static size_t copy_chunk(char *const s1, size_t const n, size_t const count,
+                         const char *const s2, size_t const len)
+{
+  /* Copy as many characters as will fit, leaving space for a terminator.
+     The source and destination may overlap when deflating in place. */
+  if (count + 1 < n)
+  {
+    size_t const copy_len = LOWEST(len, n - 1 - count);
+    DEBUG_VERBOSEF("Copying %zu bytes from %p to %p\n", copy_len,
+                   (void *)s2, (void *)(s1 + count));
+    memmove(s1 + count, s2, copy_len);
+  }
+  else
+  {
+    DEBUG_VERBOSEF("Insufficient space in the output buffer\n");
+  }
+  return count + len;
+}
+
+static void build_trie(StrDeflater *const deflater, size_t const npatterns,
+                       const char *const srch[])
+{
+  assert(deflater != NULL);
+  assert(srch != NULL || npatterns == 0);
+
+  size_t const nclasses = deflater->nclasses;
+  deflater->nstates = 1; /* root */
+
+  for (size_t p = 0; p < npatterns; ++p)
+  {
+    size_t state = RootState;
+
+    for (const char *c = srch[p]; *c != '\0'; ++c)
+    {
+      size_t *const next = &deflater->next[state * nclasses +
+                                           deflater->cls[(unsigned char)*c]];
+      /* No transition leads back to the root whilst building the trie,
+         so the root state also denotes a missing transition. */
+      if (*next == RootState)
+      {
+        *next = deflater->nstates++;
+      }
+      state = *next;
+    }
+
+    if (deflater->match[state] == NoMatch)
+    {
+      DEBUGF("Search string %zu '%s' ends in state %zu\n", p, srch[p],
+             state);
+      deflater->match[state] = p + 1;
+    }
+  }
+}
+
+static bool build_automaton(StrDeflater *const deflater)
+{
+  assert(deflater != NULL);
+
+  size_t const nclasses = deflater->nclasses;
+  size_t *const fail = malloc(deflater->nstates * sizeof(*fail));
+  size_t *const queue = malloc(deflater->nstates * sizeof(*queue));
+  if (fail == NULL || queue == NULL)
+  {
+    free(queue);
+    free(fail);
+    return false;
+  }
+
+  /* Visit states in breadth-first order so that the failure state of every
+     state has already been completed by the time the state is visited. */
+  size_t head = 0, tail = 0;
+  fail[RootState] = RootState;
+  queue[tail++] = RootState;
+
+  while (head < tail)
+  {
+    size_t const state = queue[head++];
+    size_t *const next = &deflater->next[state * nclasses];
+
+    for (size_t c = 0; c < nclasses; ++c)
+    {
+      if (next[c] != RootState)
+      {
+        size_t const child = next[c];
+        fail[child] = (state == RootState) ? RootState :
+                      deflater->next[fail[state] * nclasses + c];
+
+        /* Any search string that ends here but isn't the whole of this
+           state's string must be shorter than a string that is. */
+        if (deflater->match[child] == NoMatch)
+        {
+          deflater->match[child] = deflater->match[fail[child]];
+        }
+
+        assert(tail < deflater->nstates);
+        queue[tail++] = child;
+      }
+      else if (state != RootState)
+      {
+        next[c] = deflater->next[fail[state] * nclasses + c];
+      }
+    }
+  }
+
+  assert(tail == deflater->nstates);
+  free(queue);
+  free(fail);
+  return true;
+}
+
+/* ----------------------------------------------------------------------- */
+/*                         Public functions                                */
+
+StrDeflater *strdeflater_make(size_t const npatterns,
+                              const char *const srch[],
+                              const char *const rplc[])
+{
+  assert(srch != NULL || npatterns == 0);
+  assert(rplc != NULL || npatterns == 0);
+  DEBUGF("Making deflater for %zu search strings\n", npatterns);
+
+  StrDeflater *const deflater = malloc(sizeof(*deflater));
+  if (deflater == NULL)
+  {
+    return NULL;
+  }
+
+  *deflater = (StrDeflater){.nclasses = 0};
+
+  /* Assign a character class to every character used in a search string
+     and count the maximum number of states required. */
+  size_t nclasses = 1, max_states = 1;
+
+  deflater->srch_len = malloc(npatterns * sizeof(*deflater->srch_len));
+  deflater->rplc_len = malloc(npatterns * sizeof(*deflater->rplc_len));
+  deflater->rplc = malloc(npatterns * sizeof(*deflater->rplc));
+  if (npatterns > 0 &&
+      (deflater->srch_len == NULL || deflater->rplc_len == NULL ||
+       deflater->rplc == NULL))
+  {
+    strdeflater_destroy(deflater);
+    return NULL;
+  }
+
+  for (size_t p = 0; p < npatterns; ++p)
+  {
+    assert(srch[p] != NULL);
+    assert(*srch[p] != '\0');
+    assert(rplc[p] != NULL);
+
+    for (const char *c = srch[p]; *c != '\0'; ++c)
+    {
+      if (deflater->cls[(unsigned char)*c] == 0)
+      {
+        deflater->cls[(unsigned char)*c] = (unsigned char)nclasses++;
+      }
+    }
+
+    deflater->srch_len[p] = strlen(srch[p]);
+    deflater->rplc_len[p] = strlen(rplc[p]);
+    deflater->rplc[p] = rplc[p];
+    max_states += deflater->srch_len[p];
+  }
+
+  deflater->nclasses = nclasses;
+  if (max_states > SIZE_MAX / sizeof(size_t) / nclasses)
+  {
+    strdeflater_destroy(deflater);
+    return NULL;
+  }
+
+  deflater->next = calloc(max_states * nclasses, sizeof(*deflater->next));
+  deflater->match = calloc(max_states, sizeof(*deflater->match));
+  if (deflater->next == NULL || deflater->match == NULL)
+  {
+    strdeflater_destroy(deflater);
+    return NULL;
+  }
+
+  build_trie(deflater, npatterns, srch);
+  if (!build_automaton(deflater))
+  {
+    strdeflater_destroy(deflater);
+    return NULL;
+  }
+
+  DEBUGF("Deflater %p has %zu states and %zu character classes\n",
+         (void *)deflater, deflater->nstates, deflater->nclasses);
+
+  return deflater;
+}
+
+/* ----------------------------------------------------------------------- */
+
+void strdeflater_destroy(StrDeflater *const deflater)
+{
+  DEBUGF("Destroying deflater %p\n", (void *)deflater);
+  if (deflater != NULL)
+  {
+    free(deflater->match);
+    free(deflater->next);
+    free(deflater->rplc);
+    free(deflater->rplc_len);
+    free(deflater->srch_len);
+    free(deflater);
+  }
+}
+
+/* ----------------------------------------------------------------------- */
+
+size_t strdeflate(const StrDeflater *const deflater, char *const s1,
+                  size_t const n, const char *const s2)
+{
+  assert(deflater != NULL);
+  assert(s2 != NULL);
+  assert(s1 != NULL || n == 0);
+
+  size_t count = 0, state = RootState;
+  const char *done = s2, *p;
+
+  for (p = s2; *p != '\0'; ++p)
+  {
+    state = deflater->next[state * deflater->nclasses +
+                           deflater->cls[(unsigned char)*p]];
+
+    size_t const m = deflater->match[state];
+    if (m == NoMatch)
+    {
+      continue;
+    }
+
+    /* Copy the characters leading up to but not including the matched
+       search string, then its replacement */
+    size_t const i = m - 1;
+    const char *const start = p + 1 - deflater->srch_len[i];
+    assert(start >= done);
+    DEBUG_VERBOSEF("Found search string %zu at offset %zu\n", i,
+                   (size_t)(start - s2));
+
+    count = copy_chunk(s1, n, count, done, (size_t)(start - done));
+
+    assert(s1 != s2 || deflater->rplc_len[i] <= deflater->srch_len[i]);
+    count = copy_chunk(s1, n, count, deflater->rplc[i],
+                       deflater->rplc_len[i]);
+
+    done = p + 1;
+    state = RootState;
+  }
+
+  /* Append the remainder of the input string */
+  count = copy_chunk(s1, n, count, done, (size_t)(p - done));
+
+  if (n > 0)
+  {
+    s1[LOWEST(count, n - 1)] = '\0'; /* append a nul terminator */
+    DEBUGF("Deflated string is '%s'\n", s1);
+  }
+
+  /* Return the number of characters that would have been written had a
+     large enough output buffer been supplied. */
+  return count;
+}
@@ -25,6 +25,10 @@
   CJB: 29-Aug-22: Fix text of debug output from strdict_find_specific.
   CJB: 17-Jun-23: Include "CBUtilMisc.h" last in case any of the other
                   included header files redefine macros such as assert().
+  CJB: 17-Oct-26: Insertion no longer searches for the position of a key
+                  greater than all others. Added an append function.
+                  Discard the last search result when the array is
+                  reallocated.
  */
 
 #include <stdlib.h>
@@ -180,6 +184,45 @@ bool strdict_find_specific(StrDict *const dict, char const *const key,
   return true;
 }
 
+static bool make_space(StrDict *const dict)
+{
+  /* Ensure that there is space for at least one more item */
+  assert(dict);
+  assert(dict->nitems <= dict->nalloc);
+
+  if (dict->nitems < dict->nalloc) {
+    return true;
+  }
+
+  if (dict->nalloc == SIZE_MAX) {
+    DEBUGF("Can't reallocate dictionary at max size\n");
+    return false;
+  }
+
+  size_t new_size = ArrayInitSize;
+  if (dict->nalloc > 0) {
+    if (dict->nalloc < SIZE_MAX / ArrayGrowthFactor) {
+      new_size = dict->nalloc * ArrayGrowthFactor;
+    } else {
+      new_size = SIZE_MAX;
+    }
+  }
+
+  DEBUGF("Reallocating dictionary from %zu to %zu items\n", dict->nalloc,
+         new_size);
+  StrDictItem *const new_array = realloc(
+    dict->array, new_size * sizeof(*new_array));
+
+  if (!new_array) {
+    DEBUGF("Memory allocation failure\n");
+    return false;
+  }
+  dict->nalloc = new_size;
+  dict->array = new_array;
+  dict->candidate = NULL;
+  return true;
+}
+
 bool strdict_insert(StrDict *const dict, char const *const key,
   void *const value, size_t *const index)
 {
@@ -187,35 +230,23 @@ bool strdict_insert(StrDict *const dict, char const *const key,
      pointer in case the client dynamically allocated it, therefore allowing
      null would slow every key comparison. In any case, most library
      functions don't allow null. */
-  size_t const ins_index = strdict_bisect_left(dict, key);
-  size_t const nitems = dict->nitems;
-
-  if (nitems == dict->nalloc) {
-    if (dict->nalloc == SIZE_MAX) {
-      DEBUGF("Can't reallocate dictionary at max size\n");
-      return false;
-    }
-
-    size_t new_size = ArrayInitSize;
-    if (dict->nalloc > 0) {
-      if (dict->nalloc < SIZE_MAX / ArrayGrowthFactor) {
-        new_size = dict->nalloc * ArrayGrowthFactor;
-      } else {
-        new_size = SIZE_MAX;
-      }
-    }
+  assert(key);
+  assert(dict);
+  assert(dict->nitems <= dict->nalloc);
 
-    DEBUGF("Reallocating dictionary from %zu to %zu items\n", dict->nalloc,
-           new_size);
-    StrDictItem *const new_array = realloc(
-      dict->array, new_size * sizeof(*new_array));
+  size_t const nitems = dict->nitems;
+  size_t ins_index = nitems;
+
+  /* Keys often arrive in ascending order, in which case there is no need
+     to search for the insertion point. */
+  if (nitems > 0 && stricmp(dict->array[nitems - 1].key, key) >= 0) {
+    ins_index = strdict_bisect_left(dict, key);
+  } else {
+    DEBUGF("Key '%s' belongs at the end\n", key);
+  }
 
-    if (!new_array) {
-      DEBUGF("Memory allocation failure\n");
-      return false;
-    }
-    dict->nalloc = new_size;
-    dict->array = new_array;
+  if (!make_space(dict)) {
+    return false;
   }
 
   DEBUGF("Inserting item with key '%s', value %p at %zu\n", key, value,
@@ -252,6 +283,26 @@ bool strdict_insert(StrDict *const dict, char const *const key,
   return true;
 }
 
+bool strdict_append(StrDict *const dict, char const *const key,
+  void *const value)
+{
+  DEBUGF("Append key '%s' with value %p to dictionary %p of size %zu\n",
+         key, value, (void *)dict, dict->nitems);
+  assert(key);
+  assert(dict);
+  assert(dict->nitems <= dict->nalloc);
+  assert(dict->nitems == 0 ||
+         stricmp(dict->array[dict->nitems - 1].key, key) <= 0);
+
+  if (!make_space(dict)) {
+    return false;
+  }
+
+  assert(dict->nitems < dict->nalloc);
+  dict->array[dict->nitems++] = (StrDictItem){.key = key, .value = value};
+  return true;
+}
+
 size_t strdict_bisect_left(StrDict *const dict, char const *const key)
 {
   // Assertions here because this is the core implementation of most methods
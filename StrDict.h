@@ -30,6 +30,8 @@
                   Added the strdict_find_specific function.
                   strdictviter_remove now returns the removed item's index.
   CJB: 18-May-24: Corrected description of the return value of strdict_remove.
+  CJB: 17-Oct-26: Added the strdict_append function.
+                  Added the strdict_parallel_for_range function.
  */
 
 #ifndef StrDict_h
@@ -40,6 +42,7 @@
 #include <assert.h>
 
 #include "StringBuff.h"
+#include "ThreadPool.h"
 
 typedef struct StrDictItem {
   char const *key;
@@ -108,10 +111,24 @@ bool strdict_insert(StrDict */*dict*/, char const * /*key*/, void */*value*/,
     * Insert an item and value pair into a string dictionary. If the new
     * item's key is not unique then its position is indeterminate relative
     * to any items with equal keys that were already in the dictionary.
+    * Inserting an item with a key greater than all those already in the
+    * dictionary does not require a search.
     * Outputs the index of the inserted item if successful.
     * Returns: true if successful, otherwise false (out of memory).
     */
 
+bool strdict_append(StrDict */*dict*/, char const * /*key*/,
+                    void */*value*/);
+   /*
+    * Append an item and value pair to a string dictionary. The new item's
+    * key must not be less than any key already in the dictionary. Unlike
+    * strdict_insert, this doesn't compare the key with other keys (except
+    * to check the precondition in debug builds), so a dictionary can be
+    * built from sorted input in linear time. The index of the appended
+    * item is one less than the new count of items.
+    * Returns: true if successful, otherwise false (out of memory).
+    */
+
 static inline size_t strdict_count(StrDict const *const dict)
 {
   assert(dict);
@@ -294,6 +311,29 @@ static inline bool strdict_remove_specific(StrDict *dict,
     * of the loop and points to the current item.
     */
 
+static inline bool strdict_parallel_for_range(StrDict *const dict,
+  char const *const min_key, char const *const max_key, ThreadPool *const pool,
+  ThreadPoolRangeFn *const fn, void *const arg,
+  ThreadPoolReduction const *const reduction)
+{
+  size_t const start = strdict_bisect_left(dict, min_key);
+  size_t const end = strdict_bisect_right(dict, max_key);
+  return threadpool_for(pool, start, end > start ? end : start, fn, arg,
+                        reduction);
+}
+   /*
+    * Process a range of keys within a string dictionary in parallel by
+    * splitting the range of indices into chunks and calling 'fn' for each
+    * chunk using the threads of a pool, as for threadpool_for. 'min_key'
+    * and 'max_key' are inclusive bounds. The dictionary must not be
+    * modified until this function returns. The callback function may get
+    * the keys and values at indices within its chunk but must not call
+    * functions that search the dictionary because they are not safe to
+    * call concurrently.
+    * Returns: true if successful, otherwise false (out of memory for
+    *          partial results).
+    */
+
 typedef struct {
   StrDict *dict;
   size_t next_index, end;
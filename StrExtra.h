@@ -34,6 +34,11 @@ History:
   CJB: 11-Dec-20: Removed redundant uses of the 'extern' keyword.
   CJB: 11-Aug-22: Documented the behaviour of strdup when passed a null pointer.
                   Changed the return type of strinflate from int to size_t.
+  CJB: 17-Oct-26: Added the StrInflater type and associated functions.
+                  Added the StrDeflater type and associated functions.
+                  Added declarations of new functions strtail_n and
+                  strtail_many.
+                  Added declaration of new function strdup_many.
  */
 
 #ifndef StrExtra_h
@@ -41,6 +46,8 @@ History:
 
 /* ISO library headers */
 #include <stddef.h> /* (for size_t) */
+#include <stdbool.h>
+#include <limits.h>
 
 int stricmp(const char * /*s1*/, const char * /*s2*/);
    /*
@@ -71,6 +78,19 @@ char *strdup(const char * /*s*/);
     *          the block when no longer required.
     */
 
+char **strdup_many(size_t             /*count*/,
+                   const char *const  /*s*/[]);
+   /*
+    * Duplicates the 'count' strings pointed to by elements of the array
+    * pointed to by s by copying them into a single malloc'd block, preceded
+    * by an array of pointers to the copies. If any input is a null pointer
+    * then the corresponding output will also be a null pointer.
+    * Returns: a pointer to the array of pointers to the new strings, or a
+    *          null pointer if memory allocation failed. It is the caller's
+    *          responsibility to free the block (which also frees all the
+    *          strings) when no longer required.
+    */
+
 size_t strinflate(char       */*s1*/,
                   size_t      /*n*/,
                   const char */*s2*/,
@@ -89,6 +109,94 @@ size_t strinflate(char       */*s1*/,
     *          character.
     */
 
+typedef struct StrInflater
+{
+  bool        stop[UCHAR_MAX + 1];     /* True for the nul character and
+                                          every character to be inflated. */
+  const char *rplc[UCHAR_MAX + 1];     /* Replacement string for each
+                                          character, or NULL if none. */
+  size_t      rplc_len[UCHAR_MAX + 1]; /* Length of each replacement
+                                          string. */
+}
+StrInflater;
+   /*
+    * Precompiled form of the search and replacement strings passed to
+    * strinflate (storage lifetime is under client's control). It allows
+    * many strings to be inflated without searching the 'srch' string for
+    * each character or measuring the replacement strings each time.
+    */
+
+void strinflater_init(StrInflater      * /*inflater*/,
+                      const char       * /*srch*/,
+                      const char *const  /*rplc*/[]);
+   /*
+    * Initializes a given inflater so that every character which matches
+    * a character in the string pointed to by srch will be replaced by the
+    * string pointed to by the corresponding element of the array pointed
+    * to by rplc. If a character occurs more than once in srch then only
+    * its first occurrence is used. The replacement strings are not copied,
+    * so they must remain valid for as long as the inflater is used.
+    */
+
+size_t strinflater_inflate(const StrInflater * /*inflater*/,
+                           char              * /*s1*/,
+                           size_t              /*n*/,
+                           const char        * /*s2*/);
+   /*
+    * Inflates the string pointed to by s2 whilst copying it into the array
+    * pointed to by s1, according to the search and replacement strings
+    * given when the inflater was initialized. If n is zero, nothing is
+    * written and s1 may be a null pointer. Otherwise, output characters
+    * beyond the n-1st are discarded and a null character is written at the
+    * end of the characters actually written into the array.
+    * Returns: the number of characters that would have been written had n
+    *          been sufficiently large, not counting the terminating null
+    *          character.
+    */
+
+typedef struct StrDeflater StrDeflater;
+
+StrDeflater *strdeflater_make(size_t             /*npatterns*/,
+                              const char *const  /*srch*/[],
+                              const char *const  /*rplc*/[]);
+   /*
+    * Creates an object to replace every occurrence of the 'npatterns'
+    * strings pointed to by elements of the array pointed to by srch with
+    * the string pointed to by the corresponding element of the array
+    * pointed to by rplc. None of the search strings may be empty. If a
+    * search string occurs more than once in srch then only its first
+    * occurrence is used. Neither array need remain valid after this
+    * function returns, nor need the search strings. The replacement
+    * strings are not copied, so they must remain valid for as long as the
+    * deflater is used.
+    * Returns: On successful completion, pointer to a deflater, otherwise
+    *          null (eg. when not enough space).
+    */
+
+void strdeflater_destroy(StrDeflater * /*deflater*/);
+   /*
+    * Frees memory that was previously allocated for a deflater.
+    */
+
+size_t strdeflate(const StrDeflater * /*deflater*/,
+                  char              * /*s1*/,
+                  size_t              /*n*/,
+                  const char        * /*s2*/);
+   /*
+    * Deflates the string pointed to by s2 whilst copying it into the array
+    * pointed to by s1, in a single pass. Scanning from left to right, the
+    * first search string to end is replaced; if several end at the same
+    * character then the longest is replaced. Scanning then continues after
+    * the replaced characters. If n is zero, nothing is written and s1 may
+    * be a null pointer. Otherwise, output characters beyond the n-1st are
+    * discarded and a null character is written at the end of the characters
+    * actually written into the array. s1 may equal s2 (to deflate a string
+    * in place) if no replacement string is longer than its search string.
+    * Returns: the number of characters that would have been written had n
+    *          been sufficiently large, not counting the terminating null
+    *          character.
+    */
+
 char *strtail(const char * /*s*/, int /*c*/, size_t /*n*/);
    /*
     * Searches backwards through the string pointed to by s, stopping when
@@ -99,4 +207,30 @@ char *strtail(const char * /*s*/, int /*c*/, size_t /*n*/);
     *          fewer than n elements.
     */
 
+char *strtail_n(const char * /*s*/, size_t /*len*/, int /*c*/,
+                size_t /*n*/);
+   /*
+    * Like strtail except that the length of the string pointed to by s is
+    * given by len instead of being found by searching for its terminator.
+    * The array pointed to by s need not be null-terminated.
+    * Returns: a pointer to the character following the last path separator
+    *          found, or else the value of path if it was found to contain
+    *          fewer than n elements.
+    */
+
+void strtail_many(char              * /*tails*/[],
+                  const char *const   /*s*/[],
+                  const size_t        /*len*/[],
+                  size_t              /*count*/,
+                  int                 /*c*/,
+                  size_t              /*n*/);
+   /*
+    * Finds the tail of each of the 'count' strings pointed to by elements of
+    * the array pointed to by s, as for strtail_n, and stores a pointer to
+    * each tail in the corresponding element of the array pointed to by
+    * tails. If len is a null pointer then the length of each string is
+    * found by searching for its terminator; otherwise it is given by the
+    * corresponding element of the array pointed to by len.
+    */
+
 #endif
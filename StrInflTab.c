@@ -0,0 +1,132 @@
+/*
+ * CBUtilLib: Inflate strings using a precompiled table of replacements
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* History:
+  CJB: 17-Oct-26: Created this source file.
+*/
+
+/* ISO library headers */
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include <limits.h>
+
+/* Local headers */
+#include "StrExtra.h"
+#include "Internal/CBUtilMisc.h"
+
+static size_t copy_chunk(char *const s1, size_t const n, size_t const count,
+                         const char *const s2, size_t const len)
+{
+  /* Copy as many characters as will fit, leaving space for a terminator */
+  if (count + 1 < n)
+  {
+    size_t const copy_len = LOWEST(len, n - 1 - count);
+    DEBUG_VERBOSEF("Copying %zu bytes from %p to %p\n", copy_len,
+                   (void *)s2, (void *)(s1 + count));
+    memcpy(s1 + count, s2, copy_len);
+  }
+  else
+  {
+    DEBUG_VERBOSEF("Insufficient space in the output buffer\n");
+  }
+  return count + len;
+}
+
+/* ----------------------------------------------------------------------- */
+/*                         Public functions                                */
+
+void strinflater_init(StrInflater *const inflater, const char *const srch,
+                      const char *const rplc[])
+{
+  assert(inflater != NULL);
+  assert(srch != NULL);
+  assert(rplc != NULL);
+  DEBUGF("Initializing inflater %p for characters '%s'\n",
+         (void *)inflater, srch);
+
+  for (size_t c = 0; c <= UCHAR_MAX; ++c)
+  {
+    inflater->stop[c] = false;
+    inflater->rplc[c] = NULL;
+    inflater->rplc_len[c] = 0;
+  }
+
+  /* The nul terminator always stops a scan, whether or not it is
+     followed by another inflatable character. */
+  inflater->stop['\0'] = true;
+
+  for (size_t i = 0; srch[i] != '\0'; ++i)
+  {
+    unsigned char const c = (unsigned char)srch[i];
+
+    /* strinflate uses strchr, which finds the first occurrence */
+    if (inflater->rplc[c] == NULL)
+    {
+      assert(rplc[i] != NULL);
+      inflater->stop[c] = true;
+      inflater->rplc[c] = rplc[i];
+      inflater->rplc_len[c] = strlen(rplc[i]);
+    }
+  }
+}
+
+size_t strinflater_inflate(const StrInflater *const inflater,
+                           char *const s1, size_t const n, const char *s2)
+{
+  assert(inflater != NULL);
+  assert(s2 != NULL);
+  assert(s1 != NULL || n == 0);
+
+  size_t count = 0;
+  for (;;)
+  {
+    /* Skip the run of characters leading up to but not including the
+       next character to be inflated (or the terminator) */
+    const char *const run = s2;
+    while (!inflater->stop[(unsigned char)*s2])
+    {
+      ++s2;
+    }
+    assert(s2 >= run);
+    count = copy_chunk(s1, n, count, run, (size_t)(s2 - run));
+
+    unsigned char const c = (unsigned char)*s2;
+    if (c == '\0')
+    {
+      break;
+    }
+
+    DEBUG_VERBOSEF("Inflating character 0x%x to '%s'\n", c,
+                   inflater->rplc[c]);
+    count = copy_chunk(s1, n, count, inflater->rplc[c],
+                       inflater->rplc_len[c]);
+    ++s2; /* skip the character that was inflated */
+  }
+
+  if (n > 0)
+  {
+    s1[LOWEST(count, n - 1)] = '\0'; /* append a nul terminator */
+    DEBUGF("Inflated string is '%s'\n", s1);
+  }
+
+  /* Return the number of characters that would have been written had a
+     large enough output buffer been supplied. */
+  return count;
+}
@@ -23,29 +23,94 @@
   CJB: 11-Dec-20: Removed redundant use of the 'extern' keyword.
   CJB: 17-Jun-23: Include "CBUtilMisc.h" last in case any of the other
                   included header files redefine macros such as assert().
+  CJB: 17-Oct-26: Added strtail_n and strtail_many. The search now examines
+                  a machine word at a time and returns a pointer to the
+                  terminator instead of beyond it when n is zero.
 */
 
 /* ISO library headers */
 #include <stddef.h>
 #include <string.h>
+#include <limits.h>
 
 /* Local headers */
 #include "StrExtra.h"
+#include "Internal/WordScan.h"
 #include "Internal/CBUtilMisc.h"
 
+static const char *find_last(const char *const s, const char *end,
+                             unsigned char const c)
+{
+  /* Search backwards from 'end' for character 'c', skipping whole words
+     that don't contain it. */
+  assert(s != NULL);
+  assert(end >= s);
+
+  Word const pattern = ONES * c;
+
+  while ((size_t)(end - s) >= sizeof(Word))
+  {
+    Word w;
+    memcpy(&w, end - sizeof(Word), sizeof(w));
+    if (HAS_ZERO_BYTE(w ^ pattern))
+    {
+      break;
+    }
+    end -= sizeof(Word);
+  }
+
+  while (end > s)
+  {
+    --end;
+    if ((unsigned char)*end == c)
+    {
+      return end;
+    }
+  }
+
+  return NULL;
+}
+
+/* ----------------------------------------------------------------------- */
+/*                         Public functions                                */
+
 char *strtail(const char *s, int c, size_t n)
 {
   assert(s != NULL);
+  return strtail_n(s, strlen(s), c, n);
+}
 
-  const char *ptr = s + strlen(s); /* terminator */
+char *strtail_n(const char *const s, size_t const len, int const c,
+                size_t const n)
+{
+  assert(s != NULL);
+
+  const char *ptr = s + len; /* terminator */
   size_t count = 0;
 
-  while (ptr > s && count < n) {
-    ptr--; /* scan string backwards from terminator */
-    if (*ptr == (unsigned char)c)
-      ++count;
+  while (count < n) {
+    /* scan string backwards from terminator */
+    const char *const found = find_last(s, ptr, (unsigned char)c);
+    if (found == NULL)
+      break;
+
+    ptr = found;
+    ++count;
   }
   /* N.B. A cast to eliminate the const qualifier from return pointer
      is legitimate (compare with strrchr() and similar ANSI functions). */
-  return (char *)(count >= n ? ptr + 1 : s);
+  return (char *)(count >= n ? (count > 0 ? ptr + 1 : ptr) : s);
+}
+
+void strtail_many(char *tails[], const char *const s[],
+                  const size_t len[], size_t const count, int const c,
+                  size_t const n)
+{
+  assert(tails != NULL || count == 0);
+  assert(s != NULL || count == 0);
+
+  for (size_t i = 0; i < count; ++i) {
+    assert(s[i] != NULL);
+    tails[i] = strtail_n(s[i], len ? len[i] : strlen(s[i]), c, n);
+  }
 }
@@ -0,0 +1,85 @@
+/*
+ * CBUtilLib: Duplicate many strings in a single block of malloc'd memory
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* History:
+  CJB: 17-Oct-26: Created this source file.
+ */
+
+/* ISO library headers */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+/* Local headers */
+#include "StrExtra.h"
+#include "Internal/CBUtilMisc.h"
+
+/* ----------------------------------------------------------------------- */
+/*                         Public functions                                */
+
+char **strdup_many(size_t const count, const char *const s[])
+{
+  assert(s != NULL || count == 0);
+
+  if (count > SIZE_MAX / sizeof(char *))
+  {
+    return NULL;
+  }
+
+  /* Measure all of the strings so that only one block is needed */
+  size_t size = count * sizeof(char *);
+  for (size_t i = 0; i < count; ++i)
+  {
+    if (s[i])
+    {
+      size_t const len = strlen(s[i]) + 1;
+      if (len > SIZE_MAX - size)
+      {
+        return NULL;
+      }
+      size += len;
+    }
+  }
+
+  DEBUGF("Duplicating %zu strings in a block of %zu bytes\n", count, size);
+  char **const newarr = malloc(size ? size : 1);
+  if (newarr == NULL)
+  {
+    return NULL;
+  }
+
+  /* The strings are stored after the array of pointers to them */
+  char *newstr = (char *)(newarr + count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    if (s[i])
+    {
+      size_t const len = strlen(s[i]) + 1;
+      newarr[i] = memcpy(newstr, s[i], len);
+      newstr += len;
+    }
+    else
+    {
+      newarr[i] = NULL;
+    }
+  }
+
+  assert((size_t)(newstr - (char *)newarr) == size);
+  return newarr;
+}
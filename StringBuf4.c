@@ -0,0 +1,196 @@
+/*
+ * CBUtilLib: String buffer
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* History:
+  CJB: 17-Oct-26: New function to append an inflated string.
+                  New function to append a deflated string.
+                  New function to append a string inflated using a
+                  precompiled table of replacements, which is now also
+                  used to append a long inflated string.
+*/
+
+/* ISO library headers */
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Local headers */
+#include "StringBuff.h"
+#include "StrExtra.h"
+#include "Internal/CBUtilMisc.h"
+
+enum
+{
+  MinTableInflateLen = 64, /* Shorter strings are inflated without a table
+                              because initializing one costs more than
+                              searching 'srch' for each character. */
+};
+
+static size_t inflate(char *const s1, size_t const n, const char *const s2,
+                      const char *const srch, const char *rplc[],
+                      const StrInflater *const inflater)
+{
+  return inflater != NULL ? strinflater_inflate(inflater, s1, n, s2) :
+                            strinflate(s1, n, s2, srch, rplc);
+}
+
+static bool append_inflated(StringBuffer *const buffer, const char *const s,
+  const char *const srch, const char *rplc[],
+  const StrInflater *const inflater)
+{
+  /* Uses the given inflater, if any, otherwise 'srch' and 'rplc'. */
+  bool success = true;
+
+  assert(buffer != NULL);
+  assert(s != NULL);
+  assert(inflater != NULL || (srch != NULL && rplc != NULL));
+  DEBUG_VERBOSEF("StringBuff: Appending inflated '%s' to buffer %p ('%s')\n",
+                 s, (void *)buffer, STRING_OR_NULL(buffer->buffer));
+
+  /* If the string buffer contains the empty string "" then the length
+     may be zero (no allocated memory) as a special case. */
+  if (buffer->string_len > 0)
+  {
+    assert(buffer->buffer != NULL);
+    assert(buffer->string_len < buffer->buffer_size);
+  }
+
+  /* Measure the inflated string without writing it, so that the buffer
+     never has to be enlarged more than once. */
+  size_t const extra_chars = inflate(NULL, 0, s, srch, rplc, inflater);
+  if (extra_chars > 0)
+  {
+    /* Allocate space for the number of characters to be appended and a
+       null terminator. */
+    size_t min_size = extra_chars + 1;
+    char * const free_ptr = stringbuffer_prepare_append(buffer, &min_size);
+    if (free_ptr != NULL)
+    {
+      assert(buffer->buffer != NULL);
+
+      /* Inflate the string directly into the spare space at the end of
+         the existing string. */
+      size_t const n = inflate(free_ptr, min_size, s, srch, rplc, inflater);
+      assert(n == extra_chars);
+      NOT_USED(n);
+
+      /* Record the new string length and append a null terminator. */
+      stringbuffer_finish_append(buffer, extra_chars);
+    }
+    else
+    {
+      success = false;
+    }
+  }
+  else
+  {
+    /* Remove any previously-pending undo. */
+    buffer->undo_len = buffer->string_len;
+  }
+
+  return success;
+}
+
+bool stringbuffer_append_inflated(StringBuffer *const buffer,
+  const char *const s, const char *const srch, const char *rplc[])
+{
+  assert(buffer != NULL);
+  assert(s != NULL);
+  assert(srch != NULL);
+  assert(rplc != NULL);
+
+  /* Searching a table is much faster than searching 'srch' for every
+     character of 's' (twice), but only if 's' is long enough to repay
+     the cost of building the table. */
+  size_t len = 0;
+  while (len < MinTableInflateLen && s[len] != '\0')
+  {
+    ++len;
+  }
+
+  if (len < MinTableInflateLen)
+  {
+    return append_inflated(buffer, s, srch, rplc, NULL);
+  }
+
+  StrInflater inflater;
+  strinflater_init(&inflater, srch, rplc);
+  return append_inflated(buffer, s, NULL, NULL, &inflater);
+}
+
+bool stringbuffer_append_inflater(StringBuffer *const buffer,
+  const StrInflater *const inflater, const char *const s)
+{
+  assert(inflater != NULL);
+  return append_inflated(buffer, s, NULL, NULL, inflater);
+}
+
+bool stringbuffer_append_deflated(StringBuffer *const buffer,
+  const StrDeflater *const deflater, const char *const s)
+{
+  bool success = true;
+
+  assert(buffer != NULL);
+  assert(deflater != NULL);
+  assert(s != NULL);
+  DEBUG_VERBOSEF("StringBuff: Appending deflated '%s' to buffer %p ('%s')\n",
+                 s, (void *)buffer, STRING_OR_NULL(buffer->buffer));
+
+  /* If the string buffer contains the empty string "" then the length
+     may be zero (no allocated memory) as a special case. */
+  if (buffer->string_len > 0)
+  {
+    assert(buffer->buffer != NULL);
+    assert(buffer->string_len < buffer->buffer_size);
+  }
+
+  /* Measure the deflated string without writing it, so that the buffer
+     never has to be enlarged more than once. */
+  size_t const extra_chars = strdeflate(deflater, NULL, 0, s);
+  if (extra_chars > 0)
+  {
+    /* Allocate space for the number of characters to be appended and a
+       null terminator. */
+    size_t min_size = extra_chars + 1;
+    char * const free_ptr = stringbuffer_prepare_append(buffer, &min_size);
+    if (free_ptr != NULL)
+    {
+      assert(buffer->buffer != NULL);
+
+      /* Deflate the string directly into the spare space at the end of
+         the existing string. */
+      size_t const n = strdeflate(deflater, free_ptr, min_size, s);
+      assert(n == extra_chars);
+      NOT_USED(n);
+
+      /* Record the new string length and append a null terminator. */
+      stringbuffer_finish_append(buffer, extra_chars);
+    }
+    else
+    {
+      success = false;
+    }
+  }
+  else
+  {
+    /* Remove any previously-pending undo. */
+    buffer->undo_len = buffer->string_len;
+  }
+
+  return success;
+}
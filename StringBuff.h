@@ -32,6 +32,9 @@ History:
   CJB: 05-Feb-19: Added the stringbuffer_append_all function.
   CJB: 10-Aug-22: Converted the most trivial functions into inline functions.
   CJB: 24-Sep-23: Added functions to append a formatted string.
+  CJB: 17-Oct-26: Added the stringbuffer_append_inflated function.
+                  Added the stringbuffer_append_deflated function.
+                  Added the stringbuffer_append_inflater function.
  */
 
 #ifndef StringBuff_h
@@ -44,6 +47,9 @@ History:
 #include <stdbool.h>
 #include <stdarg.h>
 
+struct StrDeflater;
+struct StrInflater;
+
 typedef struct
 {
   size_t  buffer_size; /* No. of bytes of memory allocated for the 'buffer'
@@ -131,6 +137,55 @@ bool stringbuffer_append_separated(StringBuffer * /*buffer*/,
     *          but could not be allocated.
     */
 
+bool stringbuffer_append_inflated(StringBuffer * /*buffer*/,
+                                  const char   * /*s*/,
+                                  const char   * /*srch*/,
+                                  const char   * /*rplc*/[]);
+   /*
+    * Appends an inflated copy of the string pointed to by 's' at the end of
+    * the current string in a given buffer. Every character of 's' which
+    * matches a character in the string pointed to by 'srch' will be
+    * replaced by the string pointed to by the corresponding element of the
+    * array pointed to by 'rplc' (as for strinflate). The buffer will be
+    * enlarged no more than once. On failure, the string is unmodified. On
+    * success, the effects of this function can be undone atomically.
+    * Callers that append many strings using the same replacements should
+    * initialize a StrInflater once and call stringbuffer_append_inflater
+    * instead.
+    * Returns: true if successful, or false if additional space was required
+    *          but could not be allocated.
+    */
+
+bool stringbuffer_append_inflater(StringBuffer             * /*buffer*/,
+                                  const struct StrInflater * /*inflater*/,
+                                  const char               * /*s*/);
+   /*
+    * Appends an inflated copy of the string pointed to by 's' at the end of
+    * the current string in a given buffer. Characters are replaced as
+    * specified when the inflater was initialized (as for
+    * strinflater_inflate). This is faster than stringbuffer_append_inflated
+    * if many strings are appended using the same replacements. The buffer
+    * will be enlarged no more than once. On failure, the string is
+    * unmodified. On success, the effects of this function can be undone
+    * atomically.
+    * Returns: true if successful, or false if additional space was required
+    *          but could not be allocated.
+    */
+
+bool stringbuffer_append_deflated(StringBuffer             * /*buffer*/,
+                                  const struct StrDeflater * /*deflater*/,
+                                  const char               * /*s*/);
+   /*
+    * Appends a deflated copy of the string pointed to by 's' at the end of
+    * the current string in a given buffer. Search strings are replaced
+    * as specified when the deflater was created (as for strdeflate). The
+    * buffer will be enlarged no more than once. On failure, the string is
+    * unmodified. On success, the effects of this function can be undone
+    * atomically.
+    * Returns: true if successful, or false if additional space was required
+    *          but could not be allocated.
+    */
+
 bool stringbuffer_vprintf(StringBuffer * /*buffer*/,
                           const char * /*format*/,
                           va_list /*args*/);
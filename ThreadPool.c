@@ -0,0 +1,707 @@
+/*
+ * CBUtilLib: Pool of threads for running loops in parallel
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* History:
+  CJB: 17-Oct-26: Created this source file.
+                  Replaced the shared loop counter with a queue of tasks
+                  per thread, from which idle threads steal tasks.
+                  Count pending tasks atomically and only claim the pool's
+                  lock to wake threads that are actually waiting.
+*/
+
+/* ISO library headers */
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && \
+    !defined(__STDC_NO_THREADS__) && !defined(__STDC_NO_ATOMICS__)
+#define HAVE_THREADS
+#include <threads.h>
+#include <stdatomic.h>
+#endif
+
+/* Local headers */
+#include "ThreadPool.h"
+#include "Internal/CBUtilMisc.h"
+
+/* Each thread in a pool owns a double-ended queue of tasks. It adds tasks
+   to the back of its own queue and removes them from the back, so that the
+   most recently forked task (whose data is most likely to be cached) runs
+   first. A thread whose own queue is empty steals the oldest task from the
+   front of another thread's queue. When work is split recursively, the
+   oldest tasks are the biggest, so few steals are needed.
+
+   Slot 0 is shared by all threads that do not belong to the pool, such as
+   the thread that created it.
+
+   The numbers of queued tasks, pending tasks in each group, and waiting
+   threads are atomic counters. A thread that has nothing to do claims
+   the pool's lock, counts itself as waiting, and checks again for tasks
+   (or for its group to finish) before waiting. A thread that queues a
+   task or finishes the last task of a group only claims the lock to wake
+   other threads if any are counted as waiting. Because every access to
+   the counters is sequentially consistent, either the waiting thread sees
+   the change or the other thread sees that it is waiting. */
+
+enum
+{
+  ChunksPerWorker = 4, /* More chunks than workers balances the load if
+                          some chunks take longer than others */
+  QueueInitSize = 16,
+  QueueGrowthFactor = 2,
+};
+
+#ifdef HAVE_THREADS
+typedef struct
+{
+  ThreadPoolTaskFn *fn;
+  void             *arg;
+  ThreadPoolGroup  *group;
+}
+Task;
+
+typedef struct
+{
+  mtx_t   lock;      /* Protects all of the members below */
+  Task   *tasks;     /* Circular buffer */
+  size_t  capacity;
+  size_t  head;      /* Index of the oldest task */
+  size_t  count;
+}
+Queue;
+
+typedef struct
+{
+  ThreadPool *pool;
+  size_t      index;
+  thrd_t      thread;
+  Queue       queue;
+}
+Worker;
+
+static _Thread_local Worker *current_worker;
+
+/* The number of pending tasks in a group is stored in a size_t (so that
+   the header can be used by ISO C99 clients) but accessed atomically. */
+_Static_assert(sizeof(atomic_size_t) == sizeof(size_t) &&
+               _Alignof(atomic_size_t) == _Alignof(size_t),
+               "atomic_size_t is not compatible with size_t");
+
+static atomic_size_t *get_pending(ThreadPoolGroup *const group)
+{
+  assert(group != NULL);
+  return (atomic_size_t *)&group->pending;
+}
+#endif
+
+struct ThreadPool
+{
+  size_t              nthreads;
+#ifdef HAVE_THREADS
+  Worker             *workers;    /* Slot 0 followed by one per thread */
+  size_t              nqueues;    /* Number of initialized queues, which
+                                     may be more than the number of
+                                     threads plus one */
+  mtx_t               lock;       /* Protects 'stop' and is held by
+                                     threads about to wait */
+  cnd_t               changed;    /* Broadcast when a task is queued, a
+                                     group finishes, or the pool is being
+                                     destroyed */
+  bool                stop;
+  atomic_size_t       nqueued;    /* Number of tasks in all queues */
+  atomic_size_t       nwaiting;   /* Number of threads waiting (or about
+                                     to wait) for 'changed' */
+#endif
+};
+
+typedef struct
+{
+  ThreadPool         *pool;
+  ThreadPoolRangeFn  *fn;
+  void               *arg;
+  size_t              grain;
+  unsigned char      *partials;
+  size_t              partial_size;
+}
+Loop;
+
+typedef struct
+{
+  const Loop *loop;
+  size_t      start, end;
+}
+Range;
+
+#ifdef HAVE_THREADS
+static size_t get_slot(const ThreadPool *const pool)
+{
+  const Worker *const worker = current_worker;
+  return worker != NULL && worker->pool == pool ? worker->index : 0;
+}
+
+static bool queue_init(Queue *const queue)
+{
+  assert(queue != NULL);
+  *queue = (Queue){.tasks = NULL};
+  return mtx_init(&queue->lock, mtx_plain) == thrd_success;
+}
+
+static void queue_destroy(Queue *const queue)
+{
+  assert(queue != NULL);
+  assert(queue->count == 0);
+  mtx_destroy(&queue->lock);
+  free(queue->tasks);
+}
+
+static bool queue_push(Queue *const queue, Task const task,
+                       atomic_size_t *const nqueued)
+{
+  assert(queue != NULL);
+  bool success = true;
+
+  mtx_lock(&queue->lock);
+  if (queue->count == queue->capacity)
+  {
+    size_t const new_size = queue->capacity == 0 ? QueueInitSize :
+                            queue->capacity * QueueGrowthFactor;
+    Task *const new_tasks =
+      new_size > SIZE_MAX / QueueGrowthFactor / sizeof(Task) ? NULL :
+      malloc(new_size * sizeof(Task));
+
+    if (new_tasks == NULL)
+    {
+      success = false;
+    }
+    else
+    {
+      /* Unwrap the circular buffer */
+      for (size_t i = 0; i < queue->count; ++i)
+      {
+        new_tasks[i] = queue->tasks[(queue->head + i) % queue->capacity];
+      }
+      free(queue->tasks);
+      queue->tasks = new_tasks;
+      queue->capacity = new_size;
+      queue->head = 0;
+    }
+  }
+
+  if (success)
+  {
+    queue->tasks[(queue->head + queue->count) % queue->capacity] = task;
+    queue->count++;
+    atomic_fetch_add(nqueued, 1);
+  }
+  mtx_unlock(&queue->lock);
+
+  return success;
+}
+
+static bool queue_pop_back(Queue *const queue, Task *const task,
+                           atomic_size_t *const nqueued)
+{
+  assert(queue != NULL);
+  assert(task != NULL);
+  bool success = false;
+
+  mtx_lock(&queue->lock);
+  if (queue->count > 0)
+  {
+    queue->count--;
+    *task = queue->tasks[(queue->head + queue->count) % queue->capacity];
+    atomic_fetch_sub(nqueued, 1);
+    success = true;
+  }
+  mtx_unlock(&queue->lock);
+
+  return success;
+}
+
+static bool queue_pop_front(Queue *const queue, Task *const task,
+                            atomic_size_t *const nqueued)
+{
+  assert(queue != NULL);
+  assert(task != NULL);
+  bool success = false;
+
+  mtx_lock(&queue->lock);
+  if (queue->count > 0)
+  {
+    *task = queue->tasks[queue->head];
+    queue->head = (queue->head + 1) % queue->capacity;
+    queue->count--;
+    atomic_fetch_sub(nqueued, 1);
+    success = true;
+  }
+  mtx_unlock(&queue->lock);
+
+  return success;
+}
+
+static bool take_task(ThreadPool *const pool, size_t const slot,
+                      Task *const task)
+{
+  /* Try the thread's own queue first, then steal from the others. */
+  assert(pool != NULL);
+
+  if (queue_pop_back(&pool->workers[slot].queue, task, &pool->nqueued))
+  {
+    return true;
+  }
+
+  for (size_t i = 1; i < pool->nqueues; ++i)
+  {
+    if (atomic_load(&pool->nqueued) == 0)
+    {
+      break;
+    }
+
+    size_t const victim = (slot + i) % pool->nqueues;
+    if (queue_pop_front(&pool->workers[victim].queue, task,
+                        &pool->nqueued))
+    {
+      DEBUG_VERBOSEF("Thread %zu stole a task from %zu\n", slot, victim);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+static void wake_waiting(ThreadPool *const pool)
+{
+  /* The lock must be claimed before broadcasting, otherwise a thread
+     that has counted itself as waiting could miss the broadcast. */
+  assert(pool != NULL);
+
+  if (atomic_load(&pool->nwaiting) > 0)
+  {
+    mtx_lock(&pool->lock);
+    cnd_broadcast(&pool->changed);
+    mtx_unlock(&pool->lock);
+  }
+}
+
+static void wait_for_change(ThreadPool *const pool,
+                            ThreadPoolGroup *const group)
+{
+  /* Waits until a task is queued or the pool is being destroyed, or (if
+     'group' is not null) until all of the tasks in a group have finished.
+     May return early. */
+  assert(pool != NULL);
+
+  mtx_lock(&pool->lock);
+  atomic_fetch_add(&pool->nwaiting, 1);
+
+  bool const done = group != NULL ? atomic_load(get_pending(group)) == 0 :
+                                    pool->stop;
+  if (!done && atomic_load(&pool->nqueued) == 0)
+  {
+    cnd_wait(&pool->changed, &pool->lock);
+  }
+
+  atomic_fetch_sub(&pool->nwaiting, 1);
+  mtx_unlock(&pool->lock);
+}
+
+static void run_task(ThreadPool *const pool, const Task *const task)
+{
+  assert(pool != NULL);
+  assert(task != NULL);
+
+  task->fn(task->arg);
+
+  /* The group may cease to exist as soon as its count reaches zero */
+  size_t const pending = atomic_fetch_sub(get_pending(task->group), 1);
+  assert(pending > 0);
+  if (pending == 1)
+  {
+    wake_waiting(pool);
+  }
+}
+
+static int worker_main(void *const arg)
+{
+  Worker *const worker = arg;
+  assert(worker != NULL);
+  ThreadPool *const pool = worker->pool;
+  current_worker = worker;
+
+  for (;;)
+  {
+    Task task;
+    if (take_task(pool, worker->index, &task))
+    {
+      run_task(pool, &task);
+      continue;
+    }
+
+    mtx_lock(&pool->lock);
+    bool const stop = pool->stop;
+    mtx_unlock(&pool->lock);
+
+    if (stop)
+    {
+      break;
+    }
+
+    wait_for_change(pool, NULL);
+  }
+
+  DEBUGF("Thread %zu exiting\n", worker->index);
+  return 0;
+}
+
+static void stop_threads(ThreadPool *const pool)
+{
+  assert(pool != NULL);
+
+  mtx_lock(&pool->lock);
+  pool->stop = true;
+  cnd_broadcast(&pool->changed);
+  mtx_unlock(&pool->lock);
+
+  for (size_t i = 1; i <= pool->nthreads; ++i)
+  {
+    thrd_join(pool->workers[i].thread, NULL);
+  }
+}
+
+static void destroy_queues(ThreadPool *const pool)
+{
+  assert(pool != NULL);
+
+  for (size_t i = 0; i < pool->nqueues; ++i)
+  {
+    queue_destroy(&pool->workers[i].queue);
+  }
+}
+
+static bool start_threads(ThreadPool *const pool, size_t const nthreads)
+{
+  assert(pool != NULL);
+
+  if (nthreads == 0)
+  {
+    return true;
+  }
+
+  if (nthreads >= SIZE_MAX / sizeof(*pool->workers))
+  {
+    return false;
+  }
+
+  pool->workers = malloc((nthreads + 1) * sizeof(*pool->workers));
+  if (pool->workers == NULL)
+  {
+    return false;
+  }
+
+  for (size_t i = 0; i <= nthreads; ++i)
+  {
+    Worker *const worker = &pool->workers[i];
+    worker->pool = pool;
+    worker->index = i;
+    if (!queue_init(&worker->queue))
+    {
+      destroy_queues(pool);
+      free(pool->workers);
+      return false;
+    }
+    pool->nqueues++;
+  }
+
+  if (mtx_init(&pool->lock, mtx_plain) != thrd_success)
+  {
+    destroy_queues(pool);
+    free(pool->workers);
+    return false;
+  }
+
+  if (cnd_init(&pool->changed) != thrd_success)
+  {
+    mtx_destroy(&pool->lock);
+    destroy_queues(pool);
+    free(pool->workers);
+    return false;
+  }
+
+  atomic_init(&pool->nqueued, 0);
+  atomic_init(&pool->nwaiting, 0);
+
+  /* Carry on with fewer threads if some can't be created. The queues
+     of threads that weren't created are kept (empty) until the pool is
+     destroyed because other threads may already be looking at them. */
+  for (size_t i = 1; i <= nthreads; ++i)
+  {
+    Worker *const worker = &pool->workers[i];
+    if (thrd_create(&worker->thread, worker_main, worker) != thrd_success)
+    {
+      DEBUGF("Failed to create thread %zu\n", worker->index);
+      break;
+    }
+    pool->nthreads++;
+  }
+
+  return true;
+}
+#endif /* HAVE_THREADS */
+
+static void run_range(void *const arg)
+{
+  /* Halve the range until it is no bigger than the grain size, forking
+     a task to process each upper half. */
+  const Range *const range = arg;
+  assert(range != NULL);
+  const Loop *const loop = range->loop;
+
+  if (range->end - range->start > loop->grain)
+  {
+    size_t const mid = range->start + ((range->end - range->start) / 2);
+    Range const upper = {.loop = loop, .start = mid, .end = range->end};
+    Range const lower = {.loop = loop, .start = range->start, .end = mid};
+    ThreadPoolGroup group;
+
+    threadpool_group_init(&group);
+    threadpool_fork(loop->pool, &group, run_range, (void *)&upper);
+    run_range((void *)&lower);
+    threadpool_join(loop->pool, &group);
+    return;
+  }
+
+  void *partial = NULL;
+  if (loop->partials != NULL)
+  {
+#ifdef HAVE_THREADS
+    partial = loop->partials + (get_slot(loop->pool) * loop->partial_size);
+#else
+    partial = loop->partials;
+#endif
+  }
+
+  DEBUG_VERBOSEF("Processing %zu..%zu\n", range->start, range->end);
+  loop->fn(range->start, range->end, partial, loop->arg);
+}
+
+/* ----------------------------------------------------------------------- */
+/*                         Public functions                                */
+
+ThreadPool *threadpool_make(size_t const nthreads)
+{
+  DEBUGF("Making a pool of %zu threads\n", nthreads);
+
+  ThreadPool *const pool = malloc(sizeof(*pool));
+  if (pool == NULL)
+  {
+    return NULL;
+  }
+
+  *pool = (ThreadPool){0};
+
+#ifdef HAVE_THREADS
+  if (!start_threads(pool, nthreads))
+  {
+    free(pool);
+    return NULL;
+  }
+#else
+  NOT_USED(nthreads);
+#endif
+
+  DEBUGF("Pool %p has %zu threads\n", (void *)pool, pool->nthreads);
+  return pool;
+}
+
+/* ----------------------------------------------------------------------- */
+
+void threadpool_destroy(ThreadPool *const pool)
+{
+  DEBUGF("Destroying pool %p\n", (void *)pool);
+  if (pool == NULL)
+  {
+    return;
+  }
+
+#ifdef HAVE_THREADS
+  if (pool->workers != NULL)
+  {
+    stop_threads(pool);
+    cnd_destroy(&pool->changed);
+    mtx_destroy(&pool->lock);
+    destroy_queues(pool);
+    free(pool->workers);
+  }
+#endif
+
+  free(pool);
+}
+
+/* ----------------------------------------------------------------------- */
+
+size_t threadpool_get_nworkers(const ThreadPool *const pool)
+{
+  return pool == NULL ? 1 : pool->nthreads + 1;
+}
+
+/* ----------------------------------------------------------------------- */
+
+void threadpool_fork(ThreadPool *const pool, ThreadPoolGroup *const group,
+                     ThreadPoolTaskFn *const fn, void *const arg)
+{
+  assert(group != NULL);
+  assert(fn != NULL);
+
+#ifdef HAVE_THREADS
+  if (threadpool_get_nworkers(pool) > 1)
+  {
+    /* Count the task before queuing it in case it is stolen and
+       finished before the count would otherwise be incremented. */
+    atomic_fetch_add(get_pending(group), 1);
+
+    Task const task = {.fn = fn, .arg = arg, .group = group};
+    if (queue_push(&pool->workers[get_slot(pool)].queue, task,
+                   &pool->nqueued))
+    {
+      wake_waiting(pool);
+    }
+    else
+    {
+      DEBUGF("Failed to queue task %p\n", arg);
+      run_task(pool, &task);
+    }
+    return;
+  }
+#else
+  NOT_USED(pool);
+#endif
+
+  fn(arg);
+}
+
+/* ----------------------------------------------------------------------- */
+
+void threadpool_join(ThreadPool *const pool, ThreadPoolGroup *const group)
+{
+  assert(group != NULL);
+
+#ifdef HAVE_THREADS
+  if (threadpool_get_nworkers(pool) > 1)
+  {
+    size_t const slot = get_slot(pool);
+
+    while (atomic_load(get_pending(group)) > 0)
+    {
+      /* Help to run tasks instead of waiting idly. They may not belong
+         to the group being waited for. */
+      Task task;
+      if (take_task(pool, slot, &task))
+      {
+        run_task(pool, &task);
+        continue;
+      }
+
+      wait_for_change(pool, group);
+    }
+    return;
+  }
+#else
+  NOT_USED(pool);
+#endif
+
+  assert(group->pending == 0);
+}
+
+/* ----------------------------------------------------------------------- */
+
+bool threadpool_for(ThreadPool *const pool, size_t const start,
+                    size_t const end, ThreadPoolRangeFn *const fn,
+                    void *const arg,
+                    const ThreadPoolReduction *const reduction)
+{
+  assert(start <= end);
+  assert(fn != NULL);
+  assert(reduction == NULL || reduction->result != NULL);
+  assert(reduction == NULL || reduction->reduce != NULL);
+  assert(reduction == NULL || reduction->size > 0);
+
+  size_t const nworkers = threadpool_get_nworkers(pool);
+  DEBUGF("Processing %zu..%zu with %zu workers\n", start, end, nworkers);
+
+  if (start == end)
+  {
+    return true;
+  }
+
+  if (nworkers == 1 || end - start == 1)
+  {
+    /* The final result can be used as the only partial result because
+       it was initialized to the identity value. */
+    fn(start, end, reduction == NULL ? NULL : reduction->result, arg);
+    return true;
+  }
+
+  size_t const nchunks = nworkers * ChunksPerWorker;
+  size_t grain = (end - start) / nchunks;
+  if (grain * nchunks < end - start)
+  {
+    ++grain; /* round up */
+  }
+
+  Loop loop = {.pool = pool, .fn = fn, .arg = arg, .grain = grain};
+
+  if (reduction != NULL)
+  {
+    loop.partial_size = reduction->size;
+    if (nworkers > SIZE_MAX / loop.partial_size)
+    {
+      return false;
+    }
+
+    loop.partials = malloc(nworkers * loop.partial_size);
+    if (loop.partials == NULL)
+    {
+      return false;
+    }
+
+    for (size_t i = 0; i < nworkers; ++i)
+    {
+      memcpy(loop.partials + (i * loop.partial_size), reduction->result,
+             loop.partial_size);
+    }
+  }
+
+  Range const range = {.loop = &loop, .start = start, .end = end};
+  run_range((void *)&range);
+
+  if (reduction != NULL)
+  {
+    for (size_t i = 0; i < nworkers; ++i)
+    {
+      reduction->reduce(reduction->result,
+                        loop.partials + (i * loop.partial_size), arg);
+    }
+    free(loop.partials);
+  }
+
+  return true;
+}
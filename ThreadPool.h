@@ -0,0 +1,174 @@
+/*
+ * CBUtilLib: Pool of threads for running loops in parallel
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* ThreadPool.h declares functions to run tasks using a pool of threads.
+   Each thread has its own queue of tasks; a thread that runs out of tasks
+   steals tasks from the queues of other threads. Functions are provided to
+   fork tasks and join them (wait for them to finish), and to split a
+   range of indices into chunks to be processed in parallel.
+
+   Threads are only created if the library was compiled with an ISO C11
+   compiler that supports the optional <threads.h> and <stdatomic.h>
+   headers. Otherwise, a pool has no threads of its own and all work is
+   done by the calling thread, so that the same client code works on
+   every platform.
+
+Dependencies: ANSI C library, ISO C11 threads and atomics (optional).
+Message tokens: None
+History:
+  CJB: 17-Oct-26: Created this header file.
+                  Added functions to fork and join tasks. Threads now steal
+                  tasks from each other instead of sharing one loop counter.
+                  Threads now also require ISO C11 atomics.
+                  Documented that nested calls may update partial results.
+*/
+
+#ifndef ThreadPool_h
+#define ThreadPool_h
+
+#include <stddef.h>
+#include <stdbool.h>
+
+typedef struct ThreadPool ThreadPool;
+
+ThreadPool *threadpool_make(size_t /*nthreads*/);
+   /*
+    * Creates a pool of up to 'nthreads' threads in addition to the calling
+    * thread. Fewer threads (or none) are created if threads are not
+    * supported.
+    * Returns: On successful completion, pointer to a pool, otherwise null
+    *          (eg. when not enough space).
+    */
+
+void threadpool_destroy(ThreadPool * /*pool*/);
+   /*
+    * Waits for the threads in a pool to finish and then frees the memory
+    * that was allocated for it. Does nothing if 'pool' is null.
+    */
+
+size_t threadpool_get_nworkers(const ThreadPool * /*pool*/);
+   /*
+    * Gets the number of threads (including the calling thread) that
+    * may run tasks or process chunks of a range passed to threadpool_for.
+    * A null pointer is treated as a pool with no threads of its own.
+    * Returns: the number of worker threads, which is at least 1.
+    */
+
+typedef void ThreadPoolRangeFn(size_t /*start*/, size_t /*end*/,
+                               void * /*partial*/, void * /*arg*/);
+   /*
+    * Type of function called back to process the indices from 'start'
+    * (inclusive) to 'end' (exclusive). The value of 'arg' is that passed
+    * to threadpool_for. If a reduction was passed to threadpool_for then
+    * 'partial' points to a partial result private to the calling thread,
+    * otherwise it is null. Different chunks of the same range may be
+    * processed concurrently. Whilst a callback waits for nested tasks
+    * (e.g. in threadpool_join or a nested call to threadpool_for), the
+    * same thread may process other chunks of the same range, passing the
+    * same 'partial' pointer. A callback must therefore update '*partial'
+    * in place rather than keep a copy of it across such calls.
+    */
+
+typedef void ThreadPoolReduceFn(void * /*result*/, const void * /*partial*/,
+                                void * /*arg*/);
+   /*
+    * Type of function called back to combine a partial result into the
+    * final result. The value of 'arg' is that passed to threadpool_for.
+    */
+
+typedef struct
+{
+  void               *result; /* Final result, which must be initialized to
+                                 the identity value of the reduction (e.g.
+                                 0 for a sum) before calling
+                                 threadpool_for. */
+  size_t              size;   /* Size of the result, in bytes. */
+  ThreadPoolReduceFn *reduce; /* Function to combine partial results. */
+}
+ThreadPoolReduction;
+   /*
+    * Describes how to combine the results of processing a range in
+    * parallel.
+    */
+
+typedef void ThreadPoolTaskFn(void * /*arg*/);
+   /*
+    * Type of function called back to run a task. The value of 'arg' is
+    * that passed to threadpool_fork.
+    */
+
+typedef struct
+{
+  size_t pending; /* Private: number of tasks not yet finished */
+}
+ThreadPoolGroup;
+   /*
+    * A group of tasks that can be waited for by calling threadpool_join.
+    * Members should not be accessed directly.
+    */
+
+static inline void threadpool_group_init(ThreadPoolGroup *const group)
+{
+  group->pending = 0;
+}
+   /*
+    * Initializes an empty group of tasks.
+    */
+
+void threadpool_fork(ThreadPool * /*pool*/, ThreadPoolGroup * /*group*/,
+                     ThreadPoolTaskFn * /*fn*/, void * /*arg*/);
+   /*
+    * Adds a task to a group and queues it to be run by any of the threads
+    * of the given pool (or the calling thread). Tasks queued by the same
+    * thread are run in reverse order by that thread, unless stolen by
+    * another thread. If the pool is null, has no threads, or the task
+    * can't be queued (e.g. not enough space) then it is run immediately by
+    * the calling thread. The object pointed to by 'arg' must remain valid
+    * until the task has finished.
+    */
+
+void threadpool_join(ThreadPool * /*pool*/, ThreadPoolGroup * /*group*/);
+   /*
+    * Waits for all of the tasks in a group to finish. Whilst waiting, the
+    * calling thread runs other queued tasks. A group must be joined before
+    * it goes out of scope. It can be reused afterwards.
+    */
+
+bool threadpool_for(ThreadPool * /*pool*/, size_t /*start*/, size_t /*end*/,
+                    ThreadPoolRangeFn * /*fn*/, void * /*arg*/,
+                    const ThreadPoolReduction * /*reduction*/);
+   /*
+    * Splits the indices from 'start' (inclusive) to 'end' (exclusive) into
+    * chunks and calls 'fn' for each chunk, using the calling thread and the
+    * threads of the given pool (if not null). Does nothing if the range is
+    * empty. Returns when all chunks have been processed. If 'reduction'
+    * is not null then each thread's partial result is initialized by
+    * copying the value of 'reduction->result' and, after processing the
+    * range, combined into 'reduction->result' by calling
+    * 'reduction->reduce' in the calling thread.
+    * The range is split recursively into tasks that are forked and
+    * joined as for threadpool_fork and threadpool_join, so this function
+    * may also be called by a task or callback. If a reduction is used then
+    * this function must not be called concurrently by different threads
+    * that are not in the pool.
+    * Returns: true if successful, otherwise false (out of memory for
+    *          partial results; no chunks were processed).
+    */
+
+#endif
@@ -34,23 +34,33 @@
                   explicit in TrigTable_make.
   CJB: 17-Jun-23: Include "CBUtilMisc.h" last in case any of the other
                   included header files redefine macros such as assert().
+  CJB: 17-Oct-26: Added functions to look up the inverse sine, inverse
+                  cosine and two-argument inverse tangent.
+                  Moved the structure definition to the header file and
+                  added a function to write a table as C source code.
+                  Added functions to look up sine and cosine together and
+                  to rotate an array of points.
+                  Angles are reduced using bitwise operations instead of
+                  division if the quarter turn is a power of two.
+                  Added an option to store sine values for a full turn.
  */
 
 /* ISO library headers */
 #include <stddef.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <limits.h>
 #include <math.h>
 
 /* Local headers */
 #include "TrigTable.h"
 #include "Internal/CBUtilMisc.h"
 
-struct TrigTable
+enum
 {
-  int multiplier;
-  int quarter_turn;
-  int sine_values[];
+  ValuesPerLine = 8, /* Number of sine values per line of source code */
 };
 
 static double to_deg(TrigTable const *const table, int const angle)
@@ -59,12 +69,99 @@ static double to_deg(TrigTable const *const table, int const angle)
   return ((double)angle * 360) / (int)(table->quarter_turn * 4);
 }
 
+static bool has_full_turn(const TrigTable *const table)
+{
+  assert(table != NULL);
+  return table->full_values != NULL || table->short_values != NULL;
+}
+
+static unsigned int full_turn_index(const TrigTable *const table,
+                                    int const angle, int const phase)
+{
+  /* Reduces an angle plus a phase offset (either 0 or a quarter turn) to
+     an index into a table of sine values for a full turn. */
+  assert(table != NULL);
+  assert(phase >= 0 && phase <= table->quarter_turn);
+
+  if (table->mask != 0)
+  {
+    return ((unsigned int)angle + (unsigned int)phase) & table->mask;
+  }
+
+  int const full_turn = table->quarter_turn * 4;
+  int index = angle % full_turn;
+  if (index < 0)
+  {
+    index += full_turn;
+  }
+  index += phase;
+  if (index >= full_turn)
+  {
+    index -= full_turn;
+  }
+  return (unsigned int)index;
+}
+
+static int look_up_full_turn(const TrigTable *const table,
+                             unsigned int const index)
+{
+  assert(table != NULL);
+  assert(index < (unsigned int)table->quarter_turn * 4);
+
+  return table->short_values != NULL ? table->short_values[index] :
+                                       table->full_values[index];
+}
+
+static unsigned int fold_angle(const TrigTable *const table, int const angle,
+                               unsigned int *const quadrant)
+{
+  /* Reduces an angle to an offset within a quadrant, for a table whose
+     quarter turn is a power of two. Conversion to unsigned reduces the
+     angle modulo UINT_MAX + 1, of which a full turn is a factor, so the
+     remainder can be found by masking even if the angle is negative. */
+  assert(table != NULL);
+  assert(table->mask != 0);
+  assert(quadrant != NULL);
+
+  unsigned int const turn_offset = (unsigned int)angle & table->mask;
+  *quadrant = turn_offset >> table->shift;
+  return turn_offset & (table->mask >> 2);
+}
+
+static int look_up_sine_pow2(const TrigTable *const table, int const angle)
+{
+  /* Looks up the sine of an angle without branches, for a table whose
+     quarter turn is a power of two. */
+  unsigned int quadrant;
+  unsigned int const offset = fold_angle(table, angle, &quadrant);
+
+  /* Reflect the offset in the 2nd and 4th quadrants */
+  unsigned int const reflect = 0u - (quadrant & 1u);
+  unsigned int const index = offset ^ ((offset ^
+                             ((unsigned int)table->quarter_turn - offset)) &
+                             reflect);
+
+  /* Negate the value in the 3rd and 4th quadrants */
+  int const negate = -(int)(quadrant >> 1);
+  return (table->sine_values[index] ^ negate) - negate;
+}
+
 static int look_up_sine(const TrigTable *const table, int angle)
 {
   /* Looks up the sine of an angle from a table of pre-calculated values. */
   assert(table != NULL);
 
-  if (abs(angle) >= table->quarter_turn * 4)
+  if (has_full_turn(table))
+  {
+    return look_up_full_turn(table, full_turn_index(table, angle, 0));
+  }
+
+  if (table->mask != 0)
+  {
+    return look_up_sine_pow2(table, angle);
+  }
+
+  if (angle >= table->quarter_turn * 4 || angle <= -table->quarter_turn * 4)
   {
     angle = angle % (table->quarter_turn * 4);
   }
@@ -93,36 +190,308 @@ static int look_up_sine(const TrigTable *const table, int angle)
   return neg ? -table->sine_values[angle] : table->sine_values[angle];
 }
 
+static void look_up_sincos(const TrigTable *const table, int angle,
+                           int *const sine, int *const cosine)
+{
+  /* Looks up the sine and cosine of an angle, reducing it to the first
+     quadrant only once. */
+  assert(table != NULL);
+  assert(sine != NULL);
+  assert(cosine != NULL);
+
+  int const qt = table->quarter_turn;
+  if (has_full_turn(table))
+  {
+    /* The cosine is the sine a quarter turn later */
+    *sine = look_up_full_turn(table, full_turn_index(table, angle, 0));
+    *cosine = look_up_full_turn(table, full_turn_index(table, angle, qt));
+    return;
+  }
+
+  if (table->mask != 0)
+  {
+    /* Choose values and signs without branches */
+    unsigned int quadrant;
+    unsigned int const offset = fold_angle(table, angle, &quadrant);
+    int const near = table->sine_values[offset],
+              far = table->sine_values[(unsigned int)qt - offset];
+    int const odd = -(int)(quadrant & 1u),
+              sine_negate = -(int)(quadrant >> 1),
+              cosine_negate = -(int)((quadrant ^ (quadrant >> 1)) & 1u);
+    int const s = (near & ~odd) | (far & odd),
+              c = (far & ~odd) | (near & odd);
+    *sine = (s ^ sine_negate) - sine_negate;
+    *cosine = (c ^ cosine_negate) - cosine_negate;
+    return;
+  }
+
+  if (angle >= qt * 4 || angle <= -qt * 4)
+  {
+    angle = angle % (qt * 4);
+  }
+
+  if (angle < 0)
+  {
+    angle += qt * 4;
+  }
+
+  int const quadrant = angle / qt, offset = angle % qt;
+  int const near = table->sine_values[offset],
+            far = table->sine_values[qt - offset];
+
+  switch (quadrant)
+  {
+    case 0:
+      *sine = near;
+      *cosine = far;
+      break;
+    case 1:
+      *sine = far;
+      *cosine = -near;
+      break;
+    case 2:
+      *sine = -near;
+      *cosine = -far;
+      break;
+    default:
+      assert(quadrant == 3);
+      *sine = -far;
+      *cosine = near;
+      break;
+  }
+}
+
+static int scale_down(long long int const value, int const multiplier)
+{
+  /* Divides a product by the table's multiplier, rounding to nearest */
+  assert(multiplier > 0);
+  long long int const half = multiplier / 2;
+  return (int)((value < 0 ? value - half : value + half) / multiplier);
+}
+
+static int look_up_asin(const TrigTable *const table, int const value)
+{
+  /* Finds the angle whose sine in the table is nearest to a given value.
+     Sine values are non-decreasing between 0 and a quarter turn, so a
+     binary search can be used. */
+  assert(table != NULL);
+
+  int const magnitude = abs(LOWEST(table->multiplier,
+                                   HIGHEST(-table->multiplier, value)));
+
+  int angle;
+  if (magnitude == table->multiplier)
+  {
+    angle = table->quarter_turn;
+  }
+  else
+  {
+    /* Find the first angle with a sine not less than the given value */
+    int low = 0, high = table->quarter_turn;
+    while (low < high)
+    {
+      int const mid = low + (high - low) / 2;
+      if (table->sine_values[mid] < magnitude)
+      {
+        low = mid + 1;
+      }
+      else
+      {
+        high = mid;
+      }
+    }
+
+    angle = low;
+    if (angle > 0 && magnitude - table->sine_values[angle - 1] <
+                     table->sine_values[angle] - magnitude)
+    {
+      --angle;
+    }
+  }
+
+  return (value < 0) ? -angle : angle;
+}
+
+static int look_up_atan2(const TrigTable *const table, int const y,
+                         int const x)
+{
+  /* Finds the angle between 0 and a quarter turn at which the vector
+     (|x|,|y|) is most nearly parallel to (cos,sin) by binary search. The
+     cross product |x|.sin - |y|.cos increases monotonically with the angle
+     and is proportional to the sine of the angular error. */
+  assert(table != NULL);
+
+  long long int const ax = llabs((long long)x), ay = llabs((long long)y);
+  int const qt = table->quarter_turn;
+
+  int low = 0, high = qt;
+  while (low < high)
+  {
+    int const mid = low + (high - low) / 2;
+    if (ax * table->sine_values[mid] < ay * table->sine_values[qt - mid])
+    {
+      low = mid + 1;
+    }
+    else
+    {
+      high = mid;
+    }
+  }
+
+  int angle = low;
+  if (angle > 0)
+  {
+    long long int const above = ax * table->sine_values[angle] -
+                                ay * table->sine_values[qt - angle];
+    long long int const below = ay * table->sine_values[qt - angle + 1] -
+                                ax * table->sine_values[angle - 1];
+    if (below < above)
+    {
+      --angle;
+    }
+  }
+
+  /* Map the angle into the right quadrant */
+  if (x < 0)
+  {
+    angle = (qt * 2) - angle;
+  }
+  return (y < 0) ? -angle : angle;
+}
+
 /* ----------------------------------------------------------------------- */
-/*                         Public functions                                */
 
-TrigTable *TrigTable_make(int const multiplier, int const quarter_turn)
+static bool write_values(FILE *const f, const char *const name,
+                         const char *const type, const char *const suffix,
+                         int const count, const int *const values,
+                         const int16_t *const short_values)
+{
+  /* Writes the definition of an array of sine values as C source code */
+  assert(f != NULL);
+  assert(name != NULL);
+  assert(type != NULL);
+  assert(suffix != NULL);
+  assert((values == NULL) != (short_values == NULL));
+
+  bool success = fprintf(f, "static const %s %s_%s_values[%d] =\n{",
+                         type, name, suffix, count) >= 0;
+
+  for (int index = 0; success && index < count; index++)
+  {
+    success = fprintf(f, "%s%d,", index % ValuesPerLine ? " " : "\n  ",
+                      values != NULL ? values[index] :
+                                       short_values[index]) >= 0;
+  }
+
+  return success && fputs("\n};\n\n", f) >= 0;
+}
+
+/* ----------------------------------------------------------------------- */
+
+static TrigTable *make_table(int const multiplier, int const quarter_turn,
+                             bool const full_turn)
 {
   DEBUGF("Generating sine look-up table of size %d with scaler %d\n",
-        quarter_turn + 1, multiplier);
+        full_turn ? quarter_turn * 4 : quarter_turn + 1, multiplier);
   assert(multiplier > 0);
   assert(quarter_turn > 0);
 
-  /* Allocate memory for a table of sine values */
-  TrigTable *const table = malloc(offsetof(TrigTable, sine_values) +
-                 ((unsigned)quarter_turn + 1) * sizeof(table->sine_values[0]));
+  /* Sine values for a full turn are stored as 16-bit integers if they
+     fit. Otherwise they are stored as ints that also serve as the values
+     for the first quadrant. */
+  bool const use_short = full_turn && multiplier <= INT16_MAX;
+  size_t const nvalues = (full_turn && !use_short) ?
+                         (size_t)quarter_turn * 4 : (size_t)quarter_turn + 1;
+  size_t const nshort = use_short ? (size_t)quarter_turn * 4 : 0;
+
+  if (full_turn && quarter_turn > INT_MAX / 4)
+    return NULL;
+
+  /* Allocate memory for a table header followed by sine values */
+  TrigTable *const table = malloc(sizeof(*table) +
+                 nvalues * sizeof(table->sine_values[0]) +
+                 nshort * sizeof(table->short_values[0]));
   if (table == NULL)
     return NULL;
 
+  int *const sine_values = (int *)(table + 1);
+  int16_t *const short_values = use_short ?
+                                (int16_t *)(sine_values + nvalues) : NULL;
+
   /* Initialise table header */
   table->quarter_turn = quarter_turn;
   table->multiplier = multiplier;
+  table->sine_values = sine_values;
+  table->mask = 0;
+  table->shift = 0;
+  table->full_values = NULL;
+  table->short_values = NULL;
+
+  if ((quarter_turn & (quarter_turn - 1)) == 0 &&
+      quarter_turn <= INT_MAX / 4)
+  {
+    /* Angles can be reduced using masks and shifts */
+    while ((1 << table->shift) < quarter_turn)
+    {
+      table->shift++;
+    }
+    table->mask = ((unsigned int)quarter_turn * 4) - 1;
+    DEBUGF("Quarter turn is a power of two (shift %d, mask 0x%x)\n",
+           table->shift, table->mask);
+  }
 
   /* Generate a table of pre-calculated sine values */
   for (int index = 0; index <= quarter_turn; index++)
   {
     double radians = (index * 2.0 * PI) / (int)(quarter_turn * 4);
-    table->sine_values[index] = (int)floor(sin(radians) * (double)multiplier +
-                                           0.5);
+    sine_values[index] = (int)floor(sin(radians) * (double)multiplier + 0.5);
+  }
+
+  if (full_turn)
+  {
+    /* Unfold the first quadrant to make the others, so that the same
+       values are found whichever way they are looked up. */
+    for (int index = 0; index < quarter_turn * 4; index++)
+    {
+      int const value = look_up_sine(table, index);
+      if (use_short)
+      {
+        short_values[index] = (int16_t)value;
+      }
+      else if (index > quarter_turn)
+      {
+        sine_values[index] = value;
+      }
+    }
+
+    if (use_short)
+    {
+      table->short_values = short_values;
+    }
+    else
+    {
+      table->full_values = sine_values;
+    }
   }
+
   return table;
 }
 
+/* ----------------------------------------------------------------------- */
+/*                         Public functions                                */
+
+TrigTable *TrigTable_make(int const multiplier, int const quarter_turn)
+{
+  return make_table(multiplier, quarter_turn, false);
+}
+
+/* ----------------------------------------------------------------------- */
+
+TrigTable *TrigTable_make_full(int const multiplier, int const quarter_turn)
+{
+  return make_table(multiplier, quarter_turn, true);
+}
+
 /* ----------------------------------------------------------------------- */
 
 void TrigTable_destroy(TrigTable *const table)
@@ -133,9 +502,77 @@ void TrigTable_destroy(TrigTable *const table)
 
 /* ----------------------------------------------------------------------- */
 
+bool TrigTable_write_source(const TrigTable *const table, FILE *const f,
+                            const char *const name)
+{
+  assert(table != NULL);
+  assert(f != NULL);
+  assert(name != NULL);
+  DEBUGF("Writing trig. table at %p as '%s'\n", (void *)table, name);
+
+  /* Sine values for the first quadrant are shared with values for a full
+     turn, if those are stored as ints. */
+  const char *const sine_array = table->full_values != NULL ? "full" : "sine";
+
+  bool success = fprintf(f,
+      "/* Trigonometric table with multiplier %d and quarter turn %d */\n"
+      "#include \"TrigTable.h\"\n\n",
+      table->multiplier, table->quarter_turn) >= 0;
+
+  if (success)
+  {
+    success = write_values(f, name, "int", sine_array,
+                           table->full_values != NULL ?
+                           table->quarter_turn * 4 : table->quarter_turn + 1,
+                           table->sine_values, NULL);
+  }
+
+  if (success && table->short_values != NULL)
+  {
+    success = write_values(f, name, "int16_t", "short",
+                           table->quarter_turn * 4, NULL,
+                           table->short_values);
+  }
+
+  if (success)
+  {
+    success = fprintf(f,
+        "const TrigTable %s =\n{\n"
+        "  .multiplier = %d,\n"
+        "  .quarter_turn = %d,\n"
+        "  .sine_values = %s_%s_values,\n"
+        "  .mask = 0x%x,\n"
+        "  .shift = %d,\n",
+        name, table->multiplier, table->quarter_turn, name, sine_array,
+        table->mask, table->shift) >= 0;
+  }
+
+  if (success && table->full_values != NULL)
+  {
+    success = fprintf(f, "  .full_values = %s_full_values,\n", name) >= 0;
+  }
+
+  if (success && table->short_values != NULL)
+  {
+    success = fprintf(f, "  .short_values = %s_short_values,\n", name) >= 0;
+  }
+
+  if (success)
+  {
+    success = fputs("};\n", f) >= 0;
+  }
+
+  return success && !ferror(f);
+}
+
+/* ----------------------------------------------------------------------- */
+
 int TrigTable_look_up_cosine(const TrigTable *const table, int const angle)
 {
-  int const cosine = look_up_sine(table, angle + table->quarter_turn);
+  int const cosine = has_full_turn(table) ?
+    look_up_full_turn(table, full_turn_index(table, angle,
+                                             table->quarter_turn)) :
+    look_up_sine(table, angle + table->quarter_turn);
 
   DEBUGF("Cosine of angle %d (%f) in trig. table at %p is %d (%f)\n",
          angle, to_deg(table, angle), (void *)table,
@@ -156,3 +593,129 @@ int TrigTable_look_up_sine(const TrigTable *const table, int angle)
 
   return sine;
 }
+
+/* ----------------------------------------------------------------------- */
+
+int TrigTable_look_up_asin(const TrigTable *const table, int const value)
+{
+  int const angle = look_up_asin(table, value);
+
+  DEBUGF("Arcsine of %d (%f) in trig. table at %p is angle %d (%f)\n",
+         value, (double)value / table->multiplier, (void *)table,
+         angle, to_deg(table, angle));
+
+  return angle;
+}
+
+/* ----------------------------------------------------------------------- */
+
+int TrigTable_look_up_acos(const TrigTable *const table, int const value)
+{
+  int const angle = table->quarter_turn - look_up_asin(table, value);
+
+  DEBUGF("Arccosine of %d (%f) in trig. table at %p is angle %d (%f)\n",
+         value, (double)value / table->multiplier, (void *)table,
+         angle, to_deg(table, angle));
+
+  return angle;
+}
+
+/* ----------------------------------------------------------------------- */
+
+int TrigTable_look_up_atan2(const TrigTable *const table, int const y,
+                            int const x)
+{
+  int const angle = look_up_atan2(table, y, x);
+
+  DEBUGF("Arctangent of %d/%d in trig. table at %p is angle %d (%f)\n",
+         y, x, (void *)table, angle, to_deg(table, angle));
+
+  return angle;
+}
+
+/* ----------------------------------------------------------------------- */
+
+void TrigTable_look_up_asin_many(const TrigTable *const table,
+                                 int angles[], const int values[],
+                                 size_t const n)
+{
+  assert(table != NULL);
+  assert(angles != NULL || n == 0);
+  assert(values != NULL || n == 0);
+
+  for (size_t i = 0; i < n; ++i)
+  {
+    angles[i] = look_up_asin(table, values[i]);
+  }
+}
+
+/* ----------------------------------------------------------------------- */
+
+void TrigTable_look_up_acos_many(const TrigTable *const table,
+                                 int angles[], const int values[],
+                                 size_t const n)
+{
+  assert(table != NULL);
+  assert(angles != NULL || n == 0);
+  assert(values != NULL || n == 0);
+
+  for (size_t i = 0; i < n; ++i)
+  {
+    angles[i] = table->quarter_turn - look_up_asin(table, values[i]);
+  }
+}
+
+/* ----------------------------------------------------------------------- */
+
+void TrigTable_look_up_atan2_many(const TrigTable *const table,
+                                  int angles[], const int y[],
+                                  const int x[], size_t const n)
+{
+  assert(table != NULL);
+  assert(angles != NULL || n == 0);
+  assert(y != NULL || n == 0);
+  assert(x != NULL || n == 0);
+
+  for (size_t i = 0; i < n; ++i)
+  {
+    angles[i] = look_up_atan2(table, y[i], x[i]);
+  }
+}
+
+/* ----------------------------------------------------------------------- */
+
+void TrigTable_look_up_sincos(const TrigTable *const table, int const angle,
+                              int *const sine, int *const cosine)
+{
+  look_up_sincos(table, angle, sine, cosine);
+
+  DEBUGF("Sine and cosine of angle %d (%f) in trig. table at %p are "
+         "%d and %d\n", angle, to_deg(table, angle), (void *)table,
+         *sine, *cosine);
+}
+
+/* ----------------------------------------------------------------------- */
+
+void TrigTable_rotate_points(const TrigTable *const table, int const angle,
+                             const int in_xy[], int out_xy[], size_t const n)
+{
+  assert(table != NULL);
+  assert(in_xy != NULL || n == 0);
+  assert(out_xy != NULL || n == 0);
+
+  int sine, cosine;
+  look_up_sincos(table, angle, &sine, &cosine);
+
+  DEBUGF("Rotating %zu points by angle %d (%f) using trig. table at "
+         "%p\n", n, angle, to_deg(table, angle), (void *)table);
+
+  int const multiplier = table->multiplier;
+  for (size_t i = 0; i < n * 2; i += 2)
+  {
+    /* Read both coordinates before writing either, in case the input and
+       output arrays are the same. */
+    long long int const x = in_xy[i], y = in_xy[i + 1];
+    out_xy[i] = scale_down(x * cosine - y * sine, multiplier);
+    out_xy[i + 1] = scale_down(x * sine + y * cosine, multiplier);
+  }
+}
@@ -19,7 +19,7 @@
 
 /* TrigTable.h declares several functions that allow programs to precalculate
    trigonometric tables to a specified accuracy, and then use these for fast
-   look-up of sine and cosine values.
+   look-up of sine and cosine values and their inverses.
 
 Dependencies: ANSI C library.
 Message tokens: None
@@ -29,20 +29,67 @@ History:
                   'TrigTable' and stop using a reserved identifier (containing
                   a double underscore) as the structure tag.
   CJB: 11-Dec-20: Removed redundant uses of the 'extern' keyword.
+  CJB: 17-Oct-26: Added functions to look up the inverse sine, inverse
+                  cosine and two-argument inverse tangent.
+                  Exposed the structure definition so that tables can be
+                  defined statically, and added a function to generate such
+                  definitions.
+                  Added functions to look up sine and cosine together and
+                  to rotate an array of points.
+                  Look-up is faster if the quarter turn is a power of two.
+                  Added an option to store sine values for a full turn.
 */
 
 #ifndef TrigTable_h
 #define TrigTable_h
 
+/* ISO library headers */
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdint.h>
+
 typedef struct TrigTable TrigTable;
 
+struct TrigTable
+{
+  /* Treat all members as private. They are only visible so that tables
+     can be defined statically (see TrigTable_write_source). */
+  int          multiplier;
+  int          quarter_turn;
+  const int   *sine_values;
+  unsigned int mask;  /* One less than a full turn if the quarter turn is
+                         a power of two, otherwise 0. */
+  int          shift; /* Base 2 logarithm of the quarter turn if it is a
+                         power of two. */
+  const int     *full_values;  /* Sine values for a full turn, or NULL. */
+  const int16_t *short_values; /* Sine values for a full turn as 16-bit
+                                  integers, or NULL. */
+};
+
 TrigTable *TrigTable_make(int multiplier, int quarter_turn);
    /*
     * Creates a trigonometric table by multiplying the sine of different
     * angles by the specified 'multiplier' (the magnitude of which dictates
     * the fractional accuracy of the sine values). The size of the table is
     * dictated by 'quarter_turn', which gives the number of sine values that
-    * will be available for angles between 0 and 90 degrees.
+    * will be available for angles between 0 and 90 degrees. Angles are
+    * reduced to the first quadrant without division or branches if
+    * 'quarter_turn' is a power of two, which makes look-up faster.
+    * Returns: On successful completion, pointer to a trigonometric table
+    *          structure, otherwise null (eg. when not enough space).
+    */
+
+TrigTable *TrigTable_make_full(int multiplier, int quarter_turn);
+   /*
+    * Like TrigTable_make except that sine values are stored for a full turn
+    * instead of a quarter turn, which uses about four times as much memory.
+    * In return, the sine or cosine of an angle is found by indexing the
+    * table without first reducing the angle to the first quadrant. If the
+    * 'multiplier' is no greater than INT16_MAX then the values are stored
+    * as 16-bit integers to use less memory. Look-up is fastest if
+    * 'quarter_turn' is a power of two, in which case it only requires the
+    * angle to be masked.
     * Returns: On successful completion, pointer to a trigonometric table
     *          structure, otherwise null (eg. when not enough space).
     */
@@ -50,6 +97,20 @@ TrigTable *TrigTable_make(int multiplier, int quarter_turn);
 void TrigTable_destroy(TrigTable *table);
    /*
     * Frees memory that was previously allocated for a trigonometric table.
+    * Must not be called for a table defined by TrigTable_write_source.
+    */
+
+bool TrigTable_write_source(const TrigTable *table, FILE *f,
+                            const char *name);
+   /*
+    * Writes C source code to a given stream, to define a constant copy of a
+    * trigonometric table as an object with the specified 'name'. Such code
+    * can be generated by a program run at build time (for example from a
+    * makefile) so that the table is in read-only memory and costs nothing
+    * to create. The object can be declared elsewhere as
+    * 'extern const TrigTable name;' and used in place of a table created by
+    * TrigTable_make.
+    * Returns: true on success, or false if a write error occurred.
     */
 
 int TrigTable_look_up_cosine(const TrigTable *table, int angle);
@@ -72,4 +133,83 @@ int TrigTable_look_up_sine(const TrigTable *table, int angle);
     *          fractional value, you must divide by the 'multiplier').
     */
 
+void TrigTable_look_up_sincos(const TrigTable *table, int angle,
+                              int *sine, int *cosine);
+   /*
+    * Looks up both the sine and cosine of a specified angle, in a table of
+    * pre-calculated values. This is quicker than looking up each separately.
+    * The 'angle' value is interpreted as for TrigTable_look_up_sine. The
+    * sine is stored in the object pointed to by 'sine' and the cosine in
+    * the object pointed to by 'cosine', as integral values (to convert to
+    * fractional values, you must divide by the 'multiplier').
+    */
+
+void TrigTable_rotate_points(const TrigTable *table, int angle,
+                             const int in_xy[], int out_xy[], size_t n);
+   /*
+    * Rotates 'n' points anticlockwise about the origin by a specified angle.
+    * The coordinates of each point are read from a pair of elements (x
+    * then y) in the 'in_xy' array and the rotated coordinates are stored in
+    * the same elements of the 'out_xy' array, which may be the same array.
+    * The 'angle' value is interpreted as for TrigTable_look_up_sine. The
+    * rotated coordinates are rounded to the nearest integer and must be
+    * representable as int.
+    */
+
+int TrigTable_look_up_asin(const TrigTable *table, int value);
+   /*
+    * Looks up the inverse sine of a specified value, by searching a table of
+    * pre-calculated sine values. The 'value' is interpreted according to the
+    * 'multiplier' specified when the table was generated (i.e. a sine of 1
+    * would be 'multiplier'); values of greater magnitude are treated as
+    * +/-multiplier.
+    * Returns: The angle between -quarter_turn and quarter_turn whose sine in
+    *          the table is nearest to the specified value.
+    */
+
+int TrigTable_look_up_acos(const TrigTable *table, int value);
+   /*
+    * Looks up the inverse cosine of a specified value, by searching a table
+    * of pre-calculated sine values. The 'value' is interpreted as for
+    * TrigTable_look_up_asin.
+    * Returns: The angle between 0 and 2 * quarter_turn whose cosine in the
+    *          table is nearest to the specified value.
+    */
+
+int TrigTable_look_up_atan2(const TrigTable *table, int y, int x);
+   /*
+    * Looks up the angle of the vector (x,y) from the positive x axis, by
+    * searching a table of pre-calculated sine values. Only the ratio of
+    * 'y' to 'x' matters, so they can be in any units.
+    * Returns: The angle between -2 * quarter_turn and 2 * quarter_turn
+    *          closest to the direction of the vector, or 0 if both 'x' and
+    *          'y' are 0.
+    */
+
+void TrigTable_look_up_asin_many(const TrigTable *table, int angles[],
+                                 const int values[], size_t n);
+   /*
+    * Looks up the inverse sine of each of 'n' values in an array and stores
+    * the angles in the corresponding elements of the 'angles' array.
+    * Equivalent to calling TrigTable_look_up_asin for each value, but
+    * without the overhead of a function call per value.
+    */
+
+void TrigTable_look_up_acos_many(const TrigTable *table, int angles[],
+                                 const int values[], size_t n);
+   /*
+    * Looks up the inverse cosine of each of 'n' values in an array and
+    * stores the angles in the corresponding elements of the 'angles' array.
+    * Equivalent to calling TrigTable_look_up_acos for each value.
+    */
+
+void TrigTable_look_up_atan2_many(const TrigTable *table, int angles[],
+                                  const int y[], const int x[], size_t n);
+   /*
+    * Looks up the angle of each of 'n' vectors given by corresponding
+    * elements of the 'x' and 'y' arrays, and stores the angles in the
+    * corresponding elements of the 'angles' array. Equivalent to calling
+    * TrigTable_look_up_atan2 for each vector.
+    */
+
 #endif
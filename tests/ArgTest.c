@@ -0,0 +1,339 @@
+/*
+ * CBUtilLib test: Command-line argument utilities
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* ISO library headers */
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+/* CBUtilLib headers */
+#include "ArgUtils.h"
+
+/* Local headers */
+#include "Tests.h"
+
+#define PATH "<Wimp$ScrapDir>.ArgTest"
+
+static void write_file(const char *const s)
+{
+  FILE *const f = fopen(PATH, "wb");
+  assert(f != NULL);
+  const size_t len = strlen(s);
+  const size_t n = fwrite(s, 1, len, f);
+  assert(n == len);
+  const int err = fclose(f);
+  assert(err == 0);
+}
+
+typedef struct
+{
+  bool verbose, version;
+  long int count;
+  double scale;
+  const char *outfile, *output;
+}
+Settings;
+
+static void make_options(Settings *const settings, ArgOption options[6])
+{
+  *settings = (Settings){.count = -1, .scale = -1.0};
+
+  options[0] = (ArgOption){.name = "-verbose", .min = 2,
+    .type = ArgOptionType_Switch, .value = &settings->verbose};
+  options[1] = (ArgOption){.name = "-version", .min = 4,
+    .type = ArgOptionType_Switch, .value = &settings->version};
+  options[2] = (ArgOption){.name = "-count", .min = 2,
+    .type = ArgOptionType_Long, .value = &settings->count,
+    .long_min = 0, .long_max = 100};
+  options[3] = (ArgOption){.name = "-scale", .min = 3,
+    .type = ArgOptionType_Double, .value = &settings->scale,
+    .double_min = 0.5, .double_max = 2.0};
+  options[4] = (ArgOption){.name = "-outfile", .min = 2,
+    .type = ArgOptionType_String, .value = &settings->outfile};
+  options[5] = (ArgOption){.name = "-output", .min = 2,
+    .type = ArgOptionType_String, .value = &settings->output};
+}
+
+static void test1(void)
+{
+  /* Parse options */
+  Settings settings;
+  ArgOption options[6];
+  make_options(&settings, options);
+
+  ArgParser *const parser = arg_parser_make(options, ARRAY_SIZE(options));
+  assert(parser != NULL);
+
+  static const char *const argv[] =
+  {
+    "prog", "-v", "-vers", "-c", "0x10", "-sca", "1.5", "-outf", "a",
+    "-output", "b", "in1", "in2"
+  };
+  int n = 1;
+  bool success = arg_parser_parse(parser, ARRAY_SIZE(argv), argv, &n);
+  assert(success);
+  assert(n == 11);
+  assert(settings.verbose);
+  assert(settings.version);
+  assert(settings.count == 16);
+  assert(settings.scale == 1.5);
+  assert(strcmp(settings.outfile, "a") == 0);
+  assert(strcmp(settings.output, "b") == 0);
+
+  /* No options */
+  make_options(&settings, options);
+  n = 1;
+  success = arg_parser_parse(parser, 2, argv + 11, &n);
+  assert(success);
+  assert(n == 1);
+
+  /* End of options */
+  static const char *const argv2[] = { "prog", "-v", "--", "-count" };
+  n = 1;
+  success = arg_parser_parse(parser, ARRAY_SIZE(argv2), argv2, &n);
+  assert(success);
+  assert(n == 3);
+  assert(settings.verbose);
+  assert(settings.count == -1);
+
+  arg_parser_destroy(parser);
+}
+
+static void test2(void)
+{
+  /* Parse bad options */
+  static const struct
+  {
+    const char *args[3];
+    int n;
+  }
+  cases[] =
+  {
+    { { "-x" }, 0 },            /* unknown */
+    { { "-countdown" }, 0 },    /* unknown */
+    { { "-s", "1" }, 0 },       /* too short */
+    { { "-out", "f" }, 0 },     /* ambiguous */
+    { { "-ver" }, 0 },          /* ambiguous */
+    { { "-ve", "-c" }, 2 },     /* missing value */
+    { { "-c", "x" }, 1 },       /* bad value */
+    { { "-c", "101" }, 1 },     /* out of range */
+    { { "-scale", "0.25" }, 1 }, /* out of range */
+    { { "-output" }, 1 },       /* missing value */
+  };
+
+  for (size_t i = 0; i < ARRAY_SIZE(cases); i++)
+  {
+    Settings settings;
+    ArgOption options[6];
+    make_options(&settings, options);
+
+    ArgParser *const parser = arg_parser_make(options, ARRAY_SIZE(options));
+    assert(parser != NULL);
+
+    int argc = 0;
+    while (argc < 3 && cases[i].args[argc] != NULL)
+    {
+      argc++;
+    }
+
+    int n = 0;
+    bool const success = arg_parser_parse(parser, argc, cases[i].args, &n);
+    assert(!success);
+    assert(n == cases[i].n);
+
+    arg_parser_destroy(parser);
+  }
+}
+
+static void test3(void)
+{
+  /* Parse with many options */
+  enum { NumOptions = 500 };
+  static char names[NumOptions][16];
+  static long int values[NumOptions];
+  static ArgOption options[NumOptions];
+  static const char *argv[NumOptions * 2];
+
+  for (size_t i = 0; i < NumOptions; i++)
+  {
+    /* Add options in reverse order to check that they are sorted */
+    size_t const j = NumOptions - 1 - i;
+    sprintf(names[j], "-option%zu", j);
+    options[i] = (ArgOption){.name = names[j], .min = strlen(names[j]),
+      .type = ArgOptionType_Long, .value = &values[j],
+      .long_min = 0, .long_max = NumOptions};
+    argv[j * 2] = names[j];
+    argv[(j * 2) + 1] = names[j] + strlen("-option");
+  }
+
+  ArgParser *const parser = arg_parser_make(options, NumOptions);
+  assert(parser != NULL);
+
+  int n = 0;
+  bool const success = arg_parser_parse(parser, NumOptions * 2, argv, &n);
+  assert(success);
+  assert(n == NumOptions * 2);
+
+  for (size_t i = 0; i < NumOptions; i++)
+  {
+    assert(values[i] == (long)i);
+  }
+
+  arg_parser_destroy(parser);
+
+  /* No options */
+  ArgParser *const empty = arg_parser_make(NULL, 0);
+  assert(empty != NULL);
+  n = 0;
+  assert(!arg_parser_parse(empty, 1, argv, &n));
+  arg_parser_destroy(empty);
+}
+
+static void test4(void)
+{
+  /* Expand a response file */
+  write_file("a \"b c\"\t'd\"e'\n f\\ g \"\" h\\\\\r\n");
+
+  static const char *const argv[] = { "prog", "-x", "@" PATH, "y", "@" };
+  static const char *const expected[] =
+  {
+    "prog", "-x", "a", "b c", "d\"e", "f g", "", "h\\", "y", "@"
+  };
+
+  ArgList list;
+  bool const success = arg_list_expand(&list, ARRAY_SIZE(argv), argv);
+  assert(success);
+  assert(list.argc == ARRAY_SIZE(expected));
+  for (size_t i = 0; i < ARRAY_SIZE(expected); i++)
+  {
+    assert(strcmp(list.argv[i], expected[i]) == 0);
+  }
+  assert(list.argv[list.argc] == NULL);
+
+  arg_list_destroy(&list);
+  remove(PATH);
+}
+
+static void test5(void)
+{
+  /* Expand bad response files */
+  static const char *const argv[] = { "prog", "@" PATH };
+  ArgList list;
+
+  remove(PATH);
+  assert(!arg_list_expand(&list, ARRAY_SIZE(argv), argv));
+
+  write_file("a 'b");
+  assert(!arg_list_expand(&list, ARRAY_SIZE(argv), argv));
+
+  /* An empty file and no arguments */
+  write_file("");
+  bool success = arg_list_expand(&list, ARRAY_SIZE(argv), argv);
+  assert(success);
+  assert(list.argc == 1);
+  assert(list.argv[1] == NULL);
+  arg_list_destroy(&list);
+
+  success = arg_list_expand(&list, 0, NULL);
+  assert(success);
+  assert(list.argc == 0);
+  assert(list.argv[0] == NULL);
+  arg_list_destroy(&list);
+
+  remove(PATH);
+}
+
+static void test6(void)
+{
+  /* Expand a large response file and parse it */
+  enum { NumFiles = 200000 };
+
+  FILE *const f = fopen(PATH, "wb");
+  assert(f != NULL);
+  fputs("-count 42 -outfile \"out file\"\n", f);
+  for (int i = 0; i < NumFiles; i++)
+  {
+    fprintf(f, "file%d\n", i);
+  }
+  int const err = fclose(f);
+  assert(err == 0);
+
+  Settings settings;
+  ArgOption options[6];
+  make_options(&settings, options);
+  ArgParser *const parser = arg_parser_make(options, ARRAY_SIZE(options));
+  assert(parser != NULL);
+
+  static const char *const argv[] = { "prog", "-v", "@" PATH };
+  ArgList list;
+  bool success = arg_list_expand(&list, ARRAY_SIZE(argv), argv);
+  assert(success);
+  assert(list.argc == 2 + 4 + NumFiles);
+
+  int n = 1;
+  success = arg_parser_parse(parser, list.argc, list.argv, &n);
+  assert(success);
+  assert(n == 6);
+  assert(settings.verbose);
+  assert(settings.count == 42);
+  assert(strcmp(settings.outfile, "out file") == 0);
+
+  for (int i = 0; i < NumFiles; i++)
+  {
+    char name[32];
+    sprintf(name, "file%d", i);
+    assert(strcmp(list.argv[n + i], name) == 0);
+  }
+
+  arg_list_destroy(&list);
+  arg_parser_destroy(parser);
+  remove(PATH);
+}
+
+void ArgUtils_tests(void)
+{
+  static const struct
+  {
+    const char *test_name;
+    void (*test_func)(void);
+  }
+  unit_tests[] =
+  {
+    { "Parse options", test1 },
+    { "Parse bad options", test2 },
+    { "Parse many options", test3 },
+    { "Expand a response file", test4 },
+    { "Expand bad response files", test5 },
+    { "Expand a large response file", test6 },
+  };
+
+  for (size_t count = 0; count < ARRAY_SIZE(unit_tests); count ++)
+  {
+    printf("Test %zu/%zu : %s\n",
+           1 + count,
+           ARRAY_SIZE(unit_tests),
+           unit_tests[count].test_name);
+
+    Fortify_EnterScope();
+
+    unit_tests[count].test_func();
+
+    Fortify_LeaveScope();
+  }
+}
@@ -0,0 +1,198 @@
+/*
+ * CBUtilLib benchmark: Write values in comma-separated value format
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* Measures the throughput of csv_write_record and csv_fwrite_record for
+   several kinds of values: long integers, doubles with integral values,
+   doubles with two decimal places (such as prices) and doubles that need
+   all 17 significant digits. This program is not run as part of the unit
+   tests. */
+
+/* ISO library headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* CBUtilLib headers */
+#include "CSV.h"
+#include "StringBuff.h"
+
+enum
+{
+  ValuesPerRecord = 16,
+  NumberOfRecords = 1 << 14,
+  NumberOfValues = ValuesPerRecord * NumberOfRecords,
+  Repeats = 5,
+};
+
+typedef enum
+{
+  Kind_Long,
+  Kind_Integral,
+  Kind_Price,
+  Kind_Exact,
+}
+Kind;
+
+static long longs[NumberOfValues];
+static double doubles[NumberOfValues];
+
+static double get_time(void)
+{
+  struct timespec ts;
+  if (!timespec_get(&ts, TIME_UTC))
+  {
+    return (double)clock() / CLOCKS_PER_SEC;
+  }
+  return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+static void make_values(Kind const kind)
+{
+  for (int i = 0; i < NumberOfValues; ++i)
+  {
+    long const r = rand() - (RAND_MAX / 2);
+    switch (kind)
+    {
+      case Kind_Long:
+        longs[i] = r;
+        break;
+      case Kind_Integral:
+        doubles[i] = (double)r;
+        break;
+      case Kind_Price:
+        doubles[i] = (double)r / 100.0;
+        break;
+      case Kind_Exact:
+        doubles[i] = (double)r / 3.0;
+        break;
+    }
+  }
+}
+
+static const void *get_record(Kind const kind, int const r)
+{
+  return kind == Kind_Long ? (const void *)(longs + (r * ValuesPerRecord)) :
+                             (const void *)(doubles + (r * ValuesPerRecord));
+}
+
+static double time_buffer(Kind const kind, size_t *const len)
+{
+  /* Returns the best time to write all records to a string buffer */
+  CSVOutputType const type = kind == Kind_Long ? CSVOutputType_Long :
+                                                 CSVOutputType_Double;
+  StringBuffer buffer;
+  stringbuffer_init(&buffer);
+  double best = 0;
+
+  for (int i = 0; i < Repeats; ++i)
+  {
+    stringbuffer_truncate(&buffer, 0);
+    double const start = get_time();
+    for (int r = 0; r < NumberOfRecords; ++r)
+    {
+      if (!csv_write_record(&buffer, get_record(kind, r), type,
+                            ValuesPerRecord, ',', CSVLineEnding_LF))
+      {
+        fputs("Failed to write a record\n", stderr);
+        exit(EXIT_FAILURE);
+      }
+    }
+    double const t = get_time() - start;
+    if (i == 0 || t < best)
+    {
+      best = t;
+    }
+  }
+
+  *len = stringbuffer_get_length(&buffer);
+  stringbuffer_destroy(&buffer);
+  return best;
+}
+
+static double time_stream(Kind const kind)
+{
+  /* Returns the best time to write all records to a temporary file */
+  CSVOutputType const type = kind == Kind_Long ? CSVOutputType_Long :
+                                                 CSVOutputType_Double;
+  double best = 0;
+
+  for (int i = 0; i < Repeats; ++i)
+  {
+    FILE *const f = tmpfile();
+    if (f == NULL)
+    {
+      fputs("Failed to create a file\n", stderr);
+      exit(EXIT_FAILURE);
+    }
+
+    double const start = get_time();
+    for (int r = 0; r < NumberOfRecords; ++r)
+    {
+      if (!csv_fwrite_record(f, get_record(kind, r), type,
+                             ValuesPerRecord, ',', CSVLineEnding_LF))
+      {
+        fputs("Failed to write a record\n", stderr);
+        exit(EXIT_FAILURE);
+      }
+    }
+    double const t = get_time() - start;
+    fclose(f);
+
+    if (i == 0 || t < best)
+    {
+      best = t;
+    }
+  }
+  return best;
+}
+
+int main(void)
+{
+  static const struct
+  {
+    const char *name;
+    Kind kind;
+  }
+  kinds[] =
+  {
+    { "long", Kind_Long },
+    { "integral", Kind_Integral },
+    { "price", Kind_Price },
+    { "exact", Kind_Exact },
+  };
+
+  printf("%-10s %12s %12s %12s\n", "values", "Mvalues/s", "buffer MB/s",
+         "stream MB/s");
+
+  for (size_t k = 0; k < sizeof(kinds) / sizeof(kinds[0]); ++k)
+  {
+    make_values(kinds[k].kind);
+
+    size_t len;
+    double const buffer_time = time_buffer(kinds[k].kind, &len);
+    double const stream_time = time_stream(kinds[k].kind);
+    double const megabytes = (double)len / (1024 * 1024);
+
+    printf("%-10s %12.2f %12.1f %12.1f\n", kinds[k].name,
+           NumberOfValues / buffer_time / 1e6, megabytes / buffer_time,
+           megabytes / stream_time);
+  }
+
+  return EXIT_SUCCESS;
+}
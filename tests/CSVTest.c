@@ -0,0 +1,819 @@
+/*
+ * CBUtilLib test: Comma-separated value format
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* ISO library headers */
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <locale.h>
+
+/* CBUtilLib headers */
+#include "CSV.h"
+
+/* Local headers */
+#include "Tests.h"
+
+enum
+{
+  MaxFields = 8,
+  OutputBufferSize = 32,
+};
+
+static bool field_equals(const CSVField *const field, const char *const s)
+{
+  char buf[OutputBufferSize];
+  const size_t len = csv_field_unquote(field, buf, sizeof(buf));
+  assert(len < sizeof(buf));
+  return strcmp(buf, s) == 0;
+}
+
+static void test1(void)
+{
+  /* Split records */
+  static const char input[] =
+    "a,b,c\n"
+    "\r\n"
+    "single\r"
+    ",\n\r"
+    "last,";
+  static const struct
+  {
+    size_t nfields;
+    const char *fields[MaxFields];
+  }
+  expected[] =
+  {
+    { 3, { "a", "b", "c" } },
+    { 0, { NULL } },
+    { 1, { "single" } },
+    { 2, { "", "" } },
+    { 2, { "last", "" } },
+  };
+  CSVReader reader;
+
+  csv_reader_init(&reader, input);
+
+  for (size_t i = 0; i < ARRAY_SIZE(expected); i++)
+  {
+    CSVField fields[MaxFields];
+
+    assert(!csv_reader_at_end(&reader));
+    const size_t nfields = csv_reader_split(&reader, fields,
+                                            ARRAY_SIZE(fields));
+    assert(nfields == expected[i].nfields);
+    assert(reader.record == i + 1);
+
+    for (size_t f = 0; f < nfields; f++)
+    {
+      assert(!fields[f].quoted);
+      assert(field_equals(&fields[f], expected[i].fields[f]));
+    }
+  }
+
+  assert(csv_reader_at_end(&reader));
+}
+
+static void test2(void)
+{
+  /* Split quoted fields */
+  static const char input[] =
+    "\"a,b\",\"say \"\"hi\"\"\",\"\",plain\n"
+    "\"multi\nline\",\"\"\"\"\r\n"
+    "\"unterminated,";
+  CSVReader reader;
+  CSVField fields[MaxFields];
+
+  csv_reader_init(&reader, input);
+
+  size_t nfields = csv_reader_split(&reader, fields, ARRAY_SIZE(fields));
+  assert(nfields == 4);
+  assert(fields[0].quoted && !fields[0].escaped);
+  assert(fields[0].len == 3);
+  assert(field_equals(&fields[0], "a,b"));
+  assert(fields[1].quoted && fields[1].escaped);
+  assert(field_equals(&fields[1], "say \"hi\""));
+  assert(fields[2].quoted && fields[2].len == 0);
+  assert(!fields[3].quoted);
+  assert(field_equals(&fields[3], "plain"));
+
+  nfields = csv_reader_split(&reader, fields, ARRAY_SIZE(fields));
+  assert(nfields == 2);
+  assert(field_equals(&fields[0], "multi\nline"));
+  assert(field_equals(&fields[1], "\""));
+
+  nfields = csv_reader_split(&reader, fields, ARRAY_SIZE(fields));
+  assert(nfields == 1);
+  assert(field_equals(&fields[0], "unterminated,"));
+
+  assert(csv_reader_at_end(&reader));
+}
+
+static void test3(void)
+{
+  /* Count fields */
+  CSVReader reader;
+  CSVField fields[2];
+
+  csv_reader_init(&reader, "1,2,3,4\n5");
+
+  assert(csv_reader_split(&reader, fields, ARRAY_SIZE(fields)) == 4);
+  assert(field_equals(&fields[0], "1"));
+  assert(field_equals(&fields[1], "2"));
+
+  assert(csv_reader_split(&reader, NULL, 0) == 1);
+  assert(csv_reader_at_end(&reader));
+}
+
+static void test4(void)
+{
+  /* Parse mixed types */
+  static const CSVFieldType schema[] =
+  {
+    CSVFieldType_String, CSVFieldType_Int, CSVFieldType_Long,
+    CSVFieldType_Double, CSVFieldType_Int
+  };
+  CSVReader reader;
+  CSVValue values[ARRAY_SIZE(schema)];
+
+  csv_reader_init(&reader,
+                  "\"Smith, J\",42,-100000,2.5,\"7\"\n"
+                  "name,0x10,,1e3,\n");
+
+  size_t nfields = csv_reader_parse(&reader, schema, values,
+                                    ARRAY_SIZE(values));
+  assert(nfields == 5);
+  assert(field_equals(&values[0].as_string, "Smith, J"));
+  assert(values[1].as_int == 42);
+  assert(values[2].as_long == -100000);
+  assert(values[3].as_double == 2.5);
+  assert(values[4].as_int == 7);
+
+  /* Empty numeric fields must not be read from the following line */
+  nfields = csv_reader_parse(&reader, schema, values, ARRAY_SIZE(values));
+  assert(nfields == 5);
+  assert(field_equals(&values[0].as_string, "name"));
+  assert(values[1].as_int == 16);
+  assert(values[2].as_long == 0);
+  assert(values[3].as_double == 1000.0);
+  assert(values[4].as_int == 0);
+
+  assert(!csv_reader_at_end(&reader));
+  assert(csv_reader_parse(&reader, schema, values, ARRAY_SIZE(values)) == 0);
+  assert(csv_reader_at_end(&reader));
+}
+
+static void test5(void)
+{
+  /* Write integers */
+  static const int ints[] = { 0, 1, -1, 42, INT_MAX, INT_MIN };
+  static const long int longs[] = { LONG_MAX, LONG_MIN, -7 };
+  StringBuffer buffer;
+  char expected[128];
+
+  stringbuffer_init(&buffer);
+
+  bool success = csv_write_as_int(&buffer, ints, ARRAY_SIZE(ints), ',',
+                                  CSVLineEnding_LF);
+  assert(success);
+
+  sprintf(expected, "0,1,-1,42,%d,%d\n", INT_MAX, INT_MIN);
+  assert(strcmp(stringbuffer_get_pointer(&buffer), expected) == 0);
+
+  stringbuffer_truncate(&buffer, 0);
+  success = csv_write_as_long(&buffer, longs, ARRAY_SIZE(longs), ';',
+                              CSVLineEnding_CRLF);
+  assert(success);
+
+  sprintf(expected, "%ld;%ld;-7\r\n", LONG_MAX, LONG_MIN);
+  assert(strcmp(stringbuffer_get_pointer(&buffer), expected) == 0);
+
+  stringbuffer_destroy(&buffer);
+}
+
+static void test6(void)
+{
+  /* Write doubles */
+  static const double doubles[] =
+  {
+    0.0, 0.1, -2.5, 1.0 / 3.0, 1e300, -DBL_MIN, DBL_MAX, 123456789.0
+  };
+  StringBuffer buffer;
+
+  stringbuffer_init(&buffer);
+
+  bool success = csv_write_as_double(&buffer, doubles, ARRAY_SIZE(doubles),
+                                     ',', CSVLineEnding_LFCR);
+  assert(success);
+
+  const char *const s = stringbuffer_get_pointer(&buffer);
+  assert(strncmp(s, "0,0.1,-2.5,0.3333333333333333,1e+300,", 37) == 0);
+  assert(strcmp(s + strlen(s) - 2, "\n\r") == 0);
+
+  /* Values must be read back exactly */
+  double values[ARRAY_SIZE(doubles)];
+  char *endp;
+  const size_t nfields = csv_parse_as_double(s, &endp, values,
+                                             ARRAY_SIZE(values));
+  assert(nfields == ARRAY_SIZE(doubles));
+  for (size_t i = 0; i < ARRAY_SIZE(doubles); i++)
+  {
+    assert(values[i] == doubles[i]);
+  }
+  assert(endp != NULL && *endp == '\0');
+
+  stringbuffer_destroy(&buffer);
+}
+
+static void test7(void)
+{
+  /* Write records with all line endings */
+  static const int ints[] = { 1, 2 };
+  static const struct
+  {
+    CSVLineEnding line_ending;
+    const char *expected;
+  }
+  cases[] =
+  {
+    { CSVLineEnding_LF, "1,2\n\n" },
+    { CSVLineEnding_CR, "1,2\r\r" },
+    { CSVLineEnding_CRLF, "1,2\r\n\r\n" },
+    { CSVLineEnding_LFCR, "1,2\n\r\n\r" },
+  };
+
+  for (size_t i = 0; i < ARRAY_SIZE(cases); i++)
+  {
+    StringBuffer buffer;
+    stringbuffer_init(&buffer);
+
+    bool success = csv_write_as_int(&buffer, ints, ARRAY_SIZE(ints), ',',
+                                    cases[i].line_ending);
+    assert(success);
+    const size_t len = stringbuffer_get_length(&buffer);
+
+    /* An empty record */
+    success = csv_write_as_int(&buffer, NULL, 0, ',', cases[i].line_ending);
+    assert(success);
+
+    assert(strcmp(stringbuffer_get_pointer(&buffer), cases[i].expected) == 0);
+
+    /* Each record can be undone */
+    stringbuffer_undo(&buffer);
+    assert(stringbuffer_get_length(&buffer) == len);
+
+    stringbuffer_destroy(&buffer);
+  }
+}
+
+static void test8(void)
+{
+  /* Write records to a stream */
+  enum { NumValues = 1000 };
+  static long int longs[NumValues];
+  for (size_t i = 0; i < ARRAY_SIZE(longs); i++)
+  {
+    longs[i] = (long)(i * i) - 500;
+  }
+
+  FILE *const f = tmpfile();
+  assert(f != NULL);
+
+  bool success = csv_fwrite_record(f, longs, CSVOutputType_Long,
+                                   ARRAY_SIZE(longs), '\t',
+                                   CSVLineEnding_CRLF);
+  assert(success);
+
+  StringBuffer buffer;
+  stringbuffer_init(&buffer);
+  success = csv_write_as_long(&buffer, longs, ARRAY_SIZE(longs), '\t',
+                              CSVLineEnding_CRLF);
+  assert(success);
+
+  /* The stream must contain the same as the string buffer */
+  const size_t len = stringbuffer_get_length(&buffer);
+  assert(ftell(f) == (long)len);
+  rewind(f);
+
+  const char *const s = stringbuffer_get_pointer(&buffer);
+  for (size_t i = 0; i < len; i++)
+  {
+    assert(fgetc(f) == s[i]);
+  }
+  assert(fgetc(f) == EOF);
+
+  stringbuffer_destroy(&buffer);
+  fclose(f);
+}
+
+static void test9(void)
+{
+  /* Strict parse of valid records */
+  static const CSVFieldType schema[] =
+  {
+    CSVFieldType_Int, CSVFieldType_Long, CSVFieldType_Double,
+    CSVFieldType_String
+  };
+  CSVReader reader;
+  CSVValue values[ARRAY_SIZE(schema)];
+  CSVError error;
+
+  csv_reader_init(&reader, "1,-2, 3.5,\"a\"\"b\"\r\n\"4\",0x7f,1e-400,\n");
+
+  size_t nfields = csv_reader_parse_strict(&reader, schema, values,
+                                           ARRAY_SIZE(values), &error);
+  assert(nfields == 4);
+  assert(error.type == CSVError_None);
+  assert(values[0].as_int == 1);
+  assert(values[1].as_long == -2);
+  assert(values[2].as_double == 3.5);
+  assert(values[3].as_string.escaped);
+
+  /* Underflow isn't an error */
+  nfields = csv_reader_parse_strict(&reader, schema, values,
+                                    ARRAY_SIZE(values), &error);
+  assert(nfields == 4);
+  assert(error.type == CSVError_None);
+  assert(values[0].as_int == 4);
+  assert(values[1].as_long == 127);
+  assert(values[3].as_string.len == 0);
+
+  nfields = csv_reader_parse_strict(&reader, schema, values,
+                                    ARRAY_SIZE(values), &error);
+  assert(nfields == 0);
+  assert(error.type == CSVError_None);
+  assert(csv_reader_at_end(&reader));
+}
+
+static void test10(void)
+{
+  /* Strict parse of invalid records */
+  static const CSVFieldType schema[] =
+  {
+    CSVFieldType_Int, CSVFieldType_Long, CSVFieldType_Double,
+    CSVFieldType_String
+  };
+  static const struct
+  {
+    const char *input;
+    CSVErrorType type;
+    size_t field;
+    size_t offset;
+  }
+  cases[] =
+  {
+    { "1,2,3,a", CSVError_None, 0, 0 },
+    { "x,2,3,a", CSVError_BadValue, 0, 0 },
+    { "1,2z,3,a", CSVError_BadValue, 1, 2 },
+    { "1,2,,a", CSVError_BadValue, 2, 4 },
+    { "1,2,3.0.0,a", CSVError_BadValue, 2, 4 },
+    { "1, ,3,a", CSVError_BadValue, 1, 2 },
+    { "99999999999999999999,2,3,a", CSVError_Range, 0, 0 },
+    { "1,-99999999999999999999,3,a", CSVError_Range, 1, 2 },
+    { "1,2,1e999,a", CSVError_Range, 2, 4 },
+    { "1,2,3,\"a", CSVError_BadQuote, 3, 6 },
+    { "1,2,3,\"a\"b", CSVError_BadQuote, 3, 6 },
+    { "\"1\"\"\",2,3,a", CSVError_BadValue, 0, 0 },
+    /* The first error is reported */
+    { "1,x,y,a", CSVError_BadValue, 1, 2 },
+    /* Fields beyond the schema are checked for quoting errors */
+    { "1,2,3,a,\"b", CSVError_BadQuote, 4, 8 },
+  };
+
+  for (size_t i = 0; i < ARRAY_SIZE(cases); i++)
+  {
+    CSVReader reader;
+    CSVValue values[ARRAY_SIZE(schema)];
+    CSVError error;
+
+    /* Errors must be reported in the right record */
+    StringBuffer buffer;
+    stringbuffer_init(&buffer);
+    bool success = stringbuffer_append_all(&buffer, "5,6,7,b\n");
+    assert(success);
+    const size_t offset = stringbuffer_get_length(&buffer);
+    success = stringbuffer_append_all(&buffer, cases[i].input);
+    assert(success);
+
+    csv_reader_init(&reader, stringbuffer_get_pointer(&buffer));
+
+    size_t nfields = csv_reader_parse_strict(&reader, schema, values,
+                                             ARRAY_SIZE(values), &error);
+    assert(nfields == 4);
+    assert(error.type == CSVError_None);
+
+    nfields = csv_reader_parse_strict(&reader, schema, values,
+                                      ARRAY_SIZE(values), &error);
+    assert(nfields >= 4);
+    assert(error.type == cases[i].type);
+    if (error.type != CSVError_None)
+    {
+      assert(error.record == 1);
+      assert(error.field == cases[i].field);
+      assert(error.offset == offset + cases[i].offset);
+    }
+    assert(csv_reader_at_end(&reader));
+
+    stringbuffer_destroy(&buffer);
+  }
+}
+
+static void check_scan_format(const char *const s, size_t const len,
+                              const CSVFormat *const format)
+{
+  /* The counts must agree with a reader given the same input */
+  CSVCounts counts;
+  csv_scan_format(s, len, format, &counts);
+
+  char *const copy = malloc(len + 1);
+  assert(copy != NULL);
+  memcpy(copy, s, len);
+  copy[len] = '\0';
+
+  CSVReader reader;
+  csv_reader_init_format(&reader, copy, format);
+
+  size_t records = 0, max_fields = 0, fields = 0;
+  while (!csv_reader_at_end(&reader))
+  {
+    const size_t nfields = csv_reader_split(&reader, NULL, 0);
+    records++;
+    fields += nfields;
+    if (nfields > max_fields)
+    {
+      max_fields = nfields;
+    }
+  }
+  free(copy);
+
+  assert(counts.records == records);
+  assert(counts.max_fields == max_fields);
+  assert(counts.fields == fields);
+}
+
+static void check_scan(const char *const s, size_t const len)
+{
+  check_scan_format(s, len, NULL);
+}
+
+static void test11(void)
+{
+  /* Scan records */
+  static const char *const inputs[] =
+  {
+    "", "\n", "a", "a\n", "a,b\r\nc\n\r\nd,e,f\r", ",,,",
+    "\"a,b\"\n\"c\nd\",e", "\"a\"\"b,\"\"c\"", "\"unterminated,\n",
+    "a\"b,c", "\"a\"b\"c,d", "\"\"", "\"\"\"\"\n,",
+    "a long unquoted field that spans several words,"
+    "\"a long quoted field that spans several words\"\n"
+  };
+  static const struct
+  {
+    const char *input;
+    CSVCounts counts;
+  }
+  cases[] =
+  {
+    { "", { 1, 0, 0 } },
+    { "1,2,3\n4,5\n", { 3, 3, 5 } },
+    { "1,\"2\n3\"\r\n\r\n4", { 3, 2, 3 } },
+  };
+
+  for (size_t i = 0; i < ARRAY_SIZE(inputs); i++)
+  {
+    check_scan(inputs[i], strlen(inputs[i]));
+  }
+
+  for (size_t i = 0; i < ARRAY_SIZE(cases); i++)
+  {
+    CSVCounts counts;
+    csv_scan(cases[i].input, strlen(cases[i].input), &counts);
+    assert(counts.records == cases[i].counts.records);
+    assert(counts.max_fields == cases[i].counts.max_fields);
+    assert(counts.fields == cases[i].counts.fields);
+  }
+
+  /* The scan stops at the given length or a nul, whichever is first */
+  CSVCounts counts;
+  csv_scan("1,2\n3,4,5", 4, &counts);
+  assert(counts.records == 2);
+  assert(counts.max_fields == 2);
+
+  csv_scan("1,2\0\n3,4,5", 10, &counts);
+  assert(counts.records == 1);
+  assert(counts.max_fields == 2);
+}
+
+static void test12(void)
+{
+  /* Scan random records */
+  static const char chars[] = ",,\n\r\"\"abc";
+  enum { NumTests = 1000, MaxLen = 64 };
+  char s[MaxLen];
+
+  srand(12);
+  for (size_t i = 0; i < NumTests; i++)
+  {
+    const size_t len = (size_t)rand() % (MaxLen + 1);
+    for (size_t j = 0; j < len; j++)
+    {
+      s[j] = chars[(size_t)rand() % (sizeof(chars) - 1)];
+    }
+    check_scan(s, len);
+  }
+}
+
+static void test13(void)
+{
+  /* Scan a large input and then parse it into exact storage */
+  enum { NumRecords = 10000, NumFields = 8 };
+  static int ints[NumFields];
+  StringBuffer buffer;
+
+  stringbuffer_init(&buffer);
+  for (size_t i = 0; i < NumRecords; i++)
+  {
+    for (size_t j = 0; j < NumFields; j++)
+    {
+      ints[j] = (int)(i * j);
+    }
+    bool success = csv_write_as_int(&buffer, ints, (i % NumFields) + 1, ',',
+                                    CSVLineEnding_CRLF);
+    assert(success);
+  }
+
+  CSVCounts counts;
+  csv_scan(stringbuffer_get_pointer(&buffer),
+           stringbuffer_get_length(&buffer), &counts);
+  assert(counts.records == NumRecords + 1);
+  assert(counts.max_fields == NumFields);
+
+  int *const values = malloc(counts.fields * sizeof(*values));
+  assert(values != NULL);
+
+  size_t total = 0;
+  const char *s = stringbuffer_get_pointer(&buffer);
+  while (s != NULL)
+  {
+    char *endp;
+    total += csv_parse_as_int(s, &endp, values + total,
+                              counts.fields - total);
+    s = endp;
+  }
+  assert(total == counts.fields);
+  assert(values[total - 1] == (NumRecords - 1) * (NumFields - 1));
+
+  free(values);
+  stringbuffer_destroy(&buffer);
+}
+
+static void test14(void)
+{
+  /* Read other formats */
+  static const CSVFieldType schema[] =
+  {
+    CSVFieldType_Double, CSVFieldType_Int, CSVFieldType_String
+  };
+  CSVReader reader;
+  CSVValue values[ARRAY_SIZE(schema)];
+  CSVError error;
+
+  /* Semicolon-separated values with decimal commas */
+  CSVFormat format = {.separator = ';', .decimal_point = ',', .comment = '#'};
+  csv_reader_init_format(&reader,
+                         "# Comment\n"
+                         "1,5;2;\"a;b\"\r\n"
+                         "#\n"
+                         "-2,25e1;3,0;c,d\n"
+                         "1.5;4;e\n", &format);
+
+  size_t nfields = csv_reader_parse_strict(&reader, schema, values,
+                                           ARRAY_SIZE(values), &error);
+  assert(nfields == 3);
+  assert(error.type == CSVError_None);
+  assert(values[0].as_double == 1.5);
+  assert(values[1].as_int == 2);
+  assert(field_equals(&values[2].as_string, "a;b"));
+
+  /* Decimal commas are only accepted in double fields */
+  nfields = csv_reader_parse_strict(&reader, schema, values,
+                                    ARRAY_SIZE(values), &error);
+  assert(nfields == 3);
+  assert(error.type == CSVError_BadValue);
+  assert(error.record == 1);
+  assert(error.field == 1);
+  assert(values[0].as_double == -22.5);
+  assert(field_equals(&values[2].as_string, "c,d"));
+
+  /* Full stops aren't decimal points in this format */
+  nfields = csv_reader_parse_strict(&reader, schema, values,
+                                    ARRAY_SIZE(values), &error);
+  assert(nfields == 3);
+  assert(error.type == CSVError_BadValue);
+  assert(error.field == 0);
+
+  nfields = csv_reader_parse(&reader, schema, values, ARRAY_SIZE(values));
+  assert(nfields == 0);
+  assert(csv_reader_at_end(&reader));
+
+  /* Tab-separated values */
+  format = (CSVFormat){.separator = '\t', .decimal_point = '.'};
+  csv_reader_init_format(&reader, "0.25\t-7\ta,b\n#\t1\n", &format);
+  nfields = csv_reader_parse(&reader, schema, values, ARRAY_SIZE(values));
+  assert(nfields == 3);
+  assert(values[0].as_double == 0.25);
+  assert(values[1].as_int == -7);
+  assert(field_equals(&values[2].as_string, "a,b"));
+
+  /* No comment character */
+  nfields = csv_reader_parse(&reader, schema, values, ARRAY_SIZE(values));
+  assert(nfields == 2);
+  assert(values[0].as_double == 0.0);
+  assert(values[1].as_int == 1);
+
+  /* Other separators */
+  format = (CSVFormat){.separator = '|', .decimal_point = '.'};
+  csv_reader_init_format(&reader, "1|2|\"|\",3\n", &format);
+  CSVField fields[4];
+  nfields = csv_reader_split(&reader, fields, ARRAY_SIZE(fields));
+  assert(nfields == 3);
+  assert(field_equals(&fields[0], "1"));
+  assert(field_equals(&fields[1], "2"));
+  assert(fields[2].quoted);
+  assert(field_equals(&fields[2], "|"));
+}
+
+static void test15(void)
+{
+  /* Scan random records in other formats */
+  static const CSVFormat formats[] =
+  {
+    { .separator = '\t', .decimal_point = '.', .comment = '#' },
+    { .separator = ';', .decimal_point = ',', .comment = '\0' },
+    { .separator = '|', .decimal_point = '.', .comment = ';' },
+    { .separator = ',', .decimal_point = '.', .comment = '#' },
+  };
+  static const char chars[] = ",;|\t#\n\r\"\"ab";
+  enum { NumTests = 1000, MaxLen = 64 };
+  char s[MaxLen];
+
+  srand(15);
+  for (size_t f = 0; f < ARRAY_SIZE(formats); f++)
+  {
+    for (size_t i = 0; i < NumTests; i++)
+    {
+      const size_t len = (size_t)rand() % (MaxLen + 1);
+      for (size_t j = 0; j < len; j++)
+      {
+        s[j] = chars[(size_t)rand() % (sizeof(chars) - 1)];
+      }
+      check_scan_format(s, len, &formats[f]);
+    }
+  }
+
+  /* Comment lines aren't records */
+  CSVCounts counts;
+  static const char tsv[] = "#a,b\n1\t2\n#\n3\t4\t5\n#";
+  csv_scan_format(tsv, sizeof(tsv) - 1, &formats[0], &counts);
+  assert(counts.records == 3);
+  assert(counts.max_fields == 3);
+  assert(counts.fields == 5);
+}
+
+static void test16(void)
+{
+  /* Write doubles with few decimal places */
+  static const struct
+  {
+    double value;
+    const char *expected;
+  }
+  cases[] =
+  {
+    { 0.5, "0.5" },
+    { -0.0, "-0" },
+    { 0.001, "0.001" },
+    { -12.34, "-12.34" },
+    { 100.0, "100" },
+    { 1e15, "1000000000000000" },
+    { 9007199254740991.0, "9007199254740991" },
+    { 0.000000000000001, "0.000000000000001" },
+    { 1e-16, "1e-16" },
+  };
+
+  for (size_t i = 0; i < ARRAY_SIZE(cases); i++)
+  {
+    StringBuffer buffer;
+    stringbuffer_init(&buffer);
+
+    bool success = csv_write_as_double(&buffer, &cases[i].value, 1, ',',
+                                       CSVLineEnding_LF);
+    assert(success);
+
+    const char *const s = stringbuffer_get_pointer(&buffer);
+    assert(strlen(s) == strlen(cases[i].expected) + 1);
+    assert(strncmp(s, cases[i].expected, strlen(cases[i].expected)) == 0);
+
+    double value;
+    assert(csv_parse_as_double(s, NULL, &value, 1) == 1);
+    assert(value == cases[i].value);
+
+    stringbuffer_destroy(&buffer);
+  }
+}
+
+static void test17(void)
+{
+  /* Write doubles in a locale with a decimal comma */
+  static const char *const locales[] =
+  {
+    "de_DE.UTF-8", "de_DE", "fr_FR.UTF-8", "fr_FR", "German", "French"
+  };
+  static const double doubles[] = { 0.5, 1.0 / 3.0, 1.5e300 };
+
+  size_t i = 0;
+  while (i < ARRAY_SIZE(locales) && !setlocale(LC_NUMERIC, locales[i]))
+  {
+    i++;
+  }
+
+  /* Nothing to test if no such locale is installed */
+  if (i < ARRAY_SIZE(locales))
+  {
+    StringBuffer buffer;
+    stringbuffer_init(&buffer);
+
+    bool success = csv_write_as_double(&buffer, doubles, ARRAY_SIZE(doubles),
+                                       ',', CSVLineEnding_LF);
+    setlocale(LC_NUMERIC, "C");
+    assert(success);
+
+    const char *const s = stringbuffer_get_pointer(&buffer);
+    assert(strcmp(s, "0.5,0.3333333333333333,1.5e+300\n") == 0);
+
+    stringbuffer_destroy(&buffer);
+  }
+}
+
+void CSV_tests(void)
+{
+  static const struct
+  {
+    const char *test_name;
+    void (*test_func)(void);
+  }
+  unit_tests[] =
+  {
+    { "Split records", test1 },
+    { "Split quoted fields", test2 },
+    { "Count fields", test3 },
+    { "Parse mixed types", test4 },
+    { "Write integers", test5 },
+    { "Write doubles", test6 },
+    { "Write line endings", test7 },
+    { "Write to stream", test8 },
+    { "Strict parse valid", test9 },
+    { "Strict parse invalid", test10 },
+    { "Scan records", test11 },
+    { "Scan random records", test12 },
+    { "Scan then parse", test13 },
+    { "Read other formats", test14 },
+    { "Scan other formats", test15 },
+    { "Write doubles with few decimal places", test16 },
+    { "Write doubles with a decimal comma", test17 },
+  };
+
+  for (size_t count = 0; count < ARRAY_SIZE(unit_tests); count ++)
+  {
+    printf("Test %zu/%zu : %s\n",
+           1 + count,
+           ARRAY_SIZE(unit_tests),
+           unit_tests[count].test_name);
+
+    Fortify_EnterScope();
+
+    unit_tests[count].test_func();
+
+    Fortify_LeaveScope();
+  }
+}
@@ -0,0 +1,175 @@
+/*
+ * CBUtilLib benchmark: Deflate strings
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* Measures the throughput of strdeflate for inputs of several megabytes,
+   when measuring the output, copying it to another array, and deflating
+   in place. Every eighth word of the input is an entity to be replaced.
+   The first command-line argument, if any, is the maximum input size in
+   megabytes. This program is not run as part of the unit tests. */
+
+/* ISO library headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* CBUtilLib headers */
+#include "StrExtra.h"
+
+enum
+{
+  DefaultMaxMegabytes = 16,
+  Megabyte = 1024 * 1024,
+  EntityInterval = 8,
+  Repeats = 5,
+};
+
+static const char *const srch[] = { "&lt;", "&gt;", "&amp;", "&quot;" };
+static const char *const rplc[] = { "<", ">", "&", "\"" };
+
+static double get_time(void)
+{
+  struct timespec ts;
+  if (!timespec_get(&ts, TIME_UTC))
+  {
+    return (double)clock() / CLOCKS_PER_SEC;
+  }
+  return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+static void make_input(char *const s, size_t const size)
+{
+  /* Fill an array with words separated by spaces, some of which are
+     entities, and terminate it. */
+  static const char *const words[] = { "lorem", "ipsum", "dolor", "sit" };
+  size_t len = 0;
+
+  for (size_t i = 0; ; ++i)
+  {
+    const char *const word =
+        i % EntityInterval == 0 ?
+        srch[(i / EntityInterval) % (sizeof(srch) / sizeof(srch[0]))] :
+        words[i % (sizeof(words) / sizeof(words[0]))];
+
+    size_t const word_len = strlen(word);
+    if (len + word_len + 1 >= size)
+    {
+      break;
+    }
+    memcpy(s + len, word, word_len);
+    len += word_len;
+    s[len++] = ' ';
+  }
+  s[len] = '\0';
+}
+
+static double time_deflate(const StrDeflater *const deflater,
+                           const char *const input, char *const output,
+                           size_t const size, int const mode, size_t *const n)
+{
+  /* Mode 0 measures, 1 copies and 2 deflates in place */
+  double best = 0;
+
+  for (int i = 0; i < Repeats; ++i)
+  {
+    if (mode == 2)
+    {
+      memcpy(output, input, size);
+    }
+
+    double const start = get_time();
+    switch (mode)
+    {
+      case 0:
+        *n = strdeflate(deflater, NULL, 0, input);
+        break;
+      case 1:
+        *n = strdeflate(deflater, output, size, input);
+        break;
+      default:
+        *n = strdeflate(deflater, output, size, output);
+        break;
+    }
+    double const t = get_time() - start;
+
+    if (i == 0 || t < best)
+    {
+      best = t;
+    }
+  }
+  return best;
+}
+
+int main(int argc, char *argv[])
+{
+  size_t max_megabytes = DefaultMaxMegabytes;
+  if (argc > 1)
+  {
+    max_megabytes = strtoul(argv[1], NULL, 10);
+  }
+
+  StrDeflater *const deflater = strdeflater_make(sizeof(srch) /
+                                                 sizeof(srch[0]),
+                                                 srch, rplc);
+  if (deflater == NULL)
+  {
+    fputs("Failed to make a deflater\n", stderr);
+    return EXIT_FAILURE;
+  }
+
+  puts("Throughput in megabytes of input per second");
+  printf("%8s %12s %12s %12s\n", "MB", "measure", "copy", "in place");
+
+  for (size_t megabytes = 1; megabytes <= max_megabytes; megabytes *= 2)
+  {
+    size_t const size = megabytes * Megabyte;
+    char *const input = malloc(size);
+    char *const output = malloc(size);
+    if (input == NULL || output == NULL)
+    {
+      fputs("Failed to allocate buffers\n", stderr);
+      free(output);
+      free(input);
+      strdeflater_destroy(deflater);
+      return EXIT_FAILURE;
+    }
+
+    make_input(input, size);
+
+    double rates[3];
+    size_t n[3] = {0};
+    for (int mode = 0; mode < 3; ++mode)
+    {
+      rates[mode] = (double)megabytes /
+                    time_deflate(deflater, input, output, size, mode,
+                                 &n[mode]);
+    }
+
+    printf("%8zu %12.1f %12.1f %12.1f\n", megabytes, rates[0],
+           rates[1], rates[2]);
+
+    /* Lengths are printed to stop the work being optimized away */
+    fprintf(stderr, "%zu %zu %zu\n", n[0], n[1], n[2]);
+    free(output);
+    free(input);
+  }
+
+  strdeflater_destroy(deflater);
+  return EXIT_SUCCESS;
+}
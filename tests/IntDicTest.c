@@ -1410,6 +1410,389 @@ static void test60(void)
   remove_null_common(remove_key_only_no_pos);
 }
 
+static void test61(void)
+{
+  /* Store small values alongside keys */
+  IntValDict dict;
+  intvaldict_init(&dict, sizeof(char));
+  assert(intvaldict_count(&dict) == 0);
+
+  for (int i = NumberOfItems - 1; i >= 0; --i) {
+    char const value = (char)('a' + i);
+    size_t index = SIZE_MAX;
+    assert(intvaldict_insert(&dict, i, &value, &index));
+    assert(index == 0);
+  }
+
+  assert(intvaldict_count(&dict) == NumberOfItems);
+  INTVALDICT_FOR_EACH(&dict, i, tmp) {
+    assert(intvaldict_get_key_at(&dict, i) == (IntDictKey)i);
+    char const *const value = intvaldict_get_value_at(&dict, i);
+    assert(*value == (char)('a' + (int)i));
+  }
+
+  intvaldict_destroy(&dict, NULL, NULL);
+}
+
+static void test62(void)
+{
+  /* Store structs alongside keys and modify them in place */
+  typedef struct {
+    double x;
+    short y;
+  } Value;
+
+  IntValDict dict;
+  intvaldict_init(&dict, sizeof(Value));
+
+  for (int i = 0; i < NumberOfItems * NumberOfDuplicates; ++i) {
+    size_t index;
+    IntDictKey const key = i % NumberOfItems;
+    assert(intvaldict_insert(&dict, key, NULL, &index));
+    Value *const value = intvaldict_get_value_at(&dict, index);
+    assert((uintptr_t)value % sizeof(double) == 0);
+    *value = (Value){.x = key, .y = (short)(i / NumberOfItems)};
+  }
+
+  assert(intvaldict_count(&dict) == NumberOfItems * NumberOfDuplicates);
+  for (IntDictKey key = 0; key < NumberOfItems; ++key) {
+    size_t index;
+    Value *const value = intvaldict_find_value(&dict, key, &index);
+    assert(value != NULL);
+    assert(index == (size_t)key * NumberOfDuplicates);
+    value->x *= 2;
+
+    /* Items with equal keys remain in order of insertion */
+    INTVALDICT_FOR_EACH_IN_RANGE(&dict, key, key, i, tmp) {
+      Value const *const dup = intvaldict_get_value_at(&dict, i);
+      assert(dup->y == (short)(i - index));
+    }
+  }
+
+  INTVALDICT_FOR_EACH(&dict, i, tmp) {
+    Value const *const value = intvaldict_get_value_at(&dict, i);
+    IntDictKey const key = intvaldict_get_key_at(&dict, i);
+    assert(value->x == (value->y == 0 ? key * 2 : key));
+  }
+
+  assert(intvaldict_find_value(&dict, NumberOfItems, NULL) == NULL);
+  intvaldict_destroy(&dict, NULL, NULL);
+}
+
+static void test63(void)
+{
+  /* Remove values stored alongside keys */
+  IntValDict dict;
+  intvaldict_init(&dict, sizeof(long));
+
+  for (long i = 0; i < NumberOfItems; ++i) {
+    long const value = i * MagicValue;
+    assert(intvaldict_insert(&dict, i, &value, NULL));
+  }
+
+  size_t index;
+  assert(!intvaldict_remove(&dict, NumberOfItems, &index));
+  assert(intvaldict_remove(&dict, MiddleDivider, &index));
+  assert(index == MiddleDivider);
+  intvaldict_remove_at(&dict, 0);
+  intvaldict_remove_at(&dict, intvaldict_count(&dict) - 1);
+  assert(intvaldict_count(&dict) == NumberOfItems - 3);
+
+  INTVALDICT_FOR_EACH(&dict, i, tmp) {
+    IntDictKey const key = intvaldict_get_key_at(&dict, i);
+    assert(key != 0 && key != MiddleDivider && key != NumberOfItems - 1);
+    assert(*(long *)intvaldict_get_value_at(&dict, i) == key * MagicValue);
+  }
+
+  intvaldict_destroy(&dict, NULL, NULL);
+}
+
+static void test64(void)
+{
+  /* Destroy values stored alongside keys */
+  IntValDict dict;
+  intvaldict_init(&dict, sizeof(void *));
+
+  for (int i = 0; i < NumberOfItems; ++i) {
+    void *const value = &callbacks[i];
+    assert(intvaldict_insert(&dict, i, &value, NULL));
+  }
+
+  callback_count = 0;
+  intvaldict_destroy(&dict, record_callbacks, &dict);
+  assert(callback_count == NumberOfItems);
+  for (size_t i = 0; i < callback_count; ++i) {
+    assert(callbacks[i].key == (IntDictKey)i);
+    assert(callbacks[i].arg == &dict);
+  }
+}
+
+static void test65(void)
+{
+  /* Append in ascending order */
+  IntDict dict;
+  intdict_init(&dict);
+
+  for (size_t i = 0; i < NumberOfItems * NumberOfDuplicates; ++i) {
+    IntDictKey const key = (IntDictKey)(i / NumberOfDuplicates);
+    assert(intdict_append(&dict, key, &callbacks[i]));
+    assert(intdict_count(&dict) == i + 1);
+    assert(intdict_get_key_at(&dict, i) == key);
+    assert(intdict_get_value_at(&dict, i) == &callbacks[i]);
+  }
+
+  for (IntDictKey key = 0; key < NumberOfItems; ++key) {
+    size_t index;
+    assert(intdict_find(&dict, key, &index));
+    assert(index == (size_t)key * NumberOfDuplicates);
+  }
+
+  intdict_destroy(&dict, NULL, NULL);
+}
+
+static void test66(void)
+{
+  /* Insert in ascending order */
+  IntDict dict;
+  intdict_init(&dict);
+
+  for (size_t i = 0; i < NumberOfItems; ++i) {
+    size_t index = SIZE_MAX;
+    assert(intdict_insert(&dict, (IntDictKey)i * 2, &callbacks[i], &index));
+    assert(index == i);
+  }
+
+  /* Insert lower keys after the ascending sequence */
+  for (size_t i = 0; i < NumberOfItems; ++i) {
+    size_t index = SIZE_MAX;
+    assert(intdict_insert(&dict, (IntDictKey)i * 2 - 1, NULL, &index));
+    assert(index == i * 2);
+  }
+
+  INTDICT_FOR_EACH(&dict, i, tmp) {
+    assert(intdict_get_key_at(&dict, i) == (IntDictKey)i - 1);
+  }
+
+  intdict_destroy(&dict, NULL, NULL);
+}
+
+static void test67(void)
+{
+  /* Sliding window */
+  enum {
+    WindowSize = 100,
+    NumberOfSteps = 10000,
+  };
+  IntDict dict;
+  intdict_init(&dict);
+
+  for (IntDictKey key = 0; key < NumberOfSteps; ++key) {
+    assert(intdict_append(&dict, key, &callbacks[0]));
+
+    if (key >= WindowSize) {
+      size_t index;
+      assert(intdict_find(&dict, key - WindowSize, &index));
+      assert(index == 0);
+      intdict_remove_at(&dict, 0);
+    }
+
+    size_t const count = intdict_count(&dict);
+    assert(count == (key < WindowSize ? (size_t)key + 1 : WindowSize));
+    assert(intdict_get_key_at(&dict, 0) == key + 1 - (IntDictKey)count);
+    assert(intdict_get_key_at(&dict, count - 1) == key);
+    assert(intdict_bisect_left(&dict, key) == count - 1);
+    assert(intdict_bisect_right(&dict, key) == count);
+
+    /* Space before the head of the array must be reclaimed */
+    assert(dict.nalloc + dict.offset <= WindowSize * 2);
+  }
+
+  IntDictKey expected = NumberOfSteps - WindowSize;
+  INTDICT_FOR_EACH_IN_RANGE(&dict, 0, NumberOfSteps, i, tmp) {
+    assert(intdict_get_key_at(&dict, i) == expected++);
+  }
+  assert(expected == NumberOfSteps);
+
+  intdict_destroy(&dict, NULL, NULL);
+}
+
+static void test68(void)
+{
+  /* Remove head */
+  IntDict dict;
+  intdict_init(&dict);
+  intdict_remove_head(&dict, 0);
+
+  for (size_t i = 0; i < NumberOfItems * NumberOfDuplicates; ++i) {
+    IntDictKey const key = (IntDictKey)(i / NumberOfDuplicates);
+    assert(intdict_append(&dict, key, &callbacks[i]));
+  }
+
+  /* Expire all keys below the middle */
+  intdict_remove_head(&dict, intdict_bisect_left(&dict, MiddleDivider));
+  assert(intdict_count(&dict) ==
+         (NumberOfItems - MiddleDivider) * NumberOfDuplicates);
+  assert(intdict_get_key_at(&dict, 0) == MiddleDivider);
+  assert(intdict_get_value_at(&dict, 0) ==
+         &callbacks[MiddleDivider * NumberOfDuplicates]);
+
+  /* Insertion after removal from the head */
+  for (size_t i = 0; i < NumberOfItems; ++i) {
+    assert(intdict_insert(&dict, (IntDictKey)i, NULL, NULL));
+  }
+  assert(!intdict_find(&dict, -1, NULL));
+  for (IntDictKey key = 0; key < NumberOfItems; ++key) {
+    size_t index;
+    assert(intdict_find(&dict, key, &index));
+    if (key >= MiddleDivider) {
+      assert(index == (size_t)MiddleDivider +
+                      (size_t)(key - MiddleDivider) * (NumberOfDuplicates + 1));
+    } else {
+      assert(index == (size_t)key);
+    }
+  }
+
+  intdict_remove_head(&dict, intdict_count(&dict));
+  assert(intdict_count(&dict) == 0);
+  assert(dict.offset == 0);
+
+  intdict_destroy(&dict, NULL, NULL);
+}
+
+static void test69(void)
+{
+  /* Rank, count range and quantile */
+  enum {
+    NumberOfKeys = 100,
+  };
+  IntDict dict;
+  intdict_init(&dict);
+
+  /* Keys 1 to 100, with each even key duplicated */
+  for (IntDictKey key = 1; key <= NumberOfKeys; ++key) {
+    assert(intdict_append(&dict, key, NULL));
+    if (key % 2 == 0) {
+      assert(intdict_append(&dict, key, NULL));
+    }
+  }
+
+  assert(intdict_rank(&dict, 0) == 0);
+  assert(intdict_rank(&dict, 1) == 0);
+  assert(intdict_rank(&dict, 2) == 1);
+  assert(intdict_rank(&dict, 3) == 3);
+  assert(intdict_rank(&dict, NumberOfKeys + 1) == intdict_count(&dict));
+
+  assert(intdict_count_range(&dict, 1, 1) == 1);
+  assert(intdict_count_range(&dict, 2, 2) == 2);
+  assert(intdict_count_range(&dict, 1, 10) == 15);
+  assert(intdict_count_range(&dict, 10, 1) == 0);
+  assert(intdict_count_range(&dict, INTDICTKEY_MIN, INTDICTKEY_MAX) ==
+         intdict_count(&dict));
+  assert(intdict_count_range(&dict, NumberOfKeys + 1, INTDICTKEY_MAX) == 0);
+
+  assert(intdict_quantile(&dict, 0.0) == 1);
+  assert(intdict_quantile(&dict, 1.0) == NumberOfKeys);
+  assert(intdict_quantile(&dict, 0.5) == 50);
+  assert(intdict_quantile(&dict, 0.99) == NumberOfKeys);
+  assert(intdict_quantile(&dict, 0.01) == 2);
+
+  intdict_destroy(&dict, NULL, NULL);
+}
+
+static long long sum_keys(IntDict *const dict, IntDictKey const min_key,
+                          IntDictKey const max_key)
+{
+  long long sum = 0;
+  INTDICT_FOR_EACH(dict, i, tmp) {
+    IntDictKey const key = intdict_get_key_at(dict, i);
+    if (key >= min_key && key <= max_key) {
+      sum += key;
+    }
+  }
+  return sum;
+}
+
+static void check_sums(IntDict *const dict)
+{
+  static IntDictKey const bounds[] = {
+    INTDICTKEY_MIN, -100, -1, 0, 1, 7, 50, 99, 500, INTDICTKEY_MAX
+  };
+
+  for (size_t i = 0; i < ARRAY_SIZE(bounds); ++i) {
+    for (size_t j = 0; j < ARRAY_SIZE(bounds); ++j) {
+      assert(intdict_sum_range(dict, bounds[i], bounds[j]) ==
+             sum_keys(dict, bounds[i], bounds[j]));
+    }
+  }
+}
+
+static void test70(void)
+{
+  /* Sum range with and without an index */
+  enum {
+    NumberOfSteps = 200,
+    KeyRange = 200,
+  };
+  IntDict dict;
+  intdict_init(&dict);
+  assert(intdict_sum_range(&dict, INTDICTKEY_MIN, INTDICTKEY_MAX) == 0);
+
+  unsigned int seed = 1;
+  for (int step = 0; step < NumberOfSteps; ++step) {
+    seed = seed * 1103515245u + 12345u;
+    IntDictKey const key = (IntDictKey)((seed >> 16) % KeyRange) -
+                           (KeyRange / 2);
+
+    switch ((seed >> 8) % 4) {
+      case 0:
+        if (intdict_count(&dict) > 0) {
+          intdict_remove_at(&dict, (seed >> 4) % intdict_count(&dict));
+        }
+        break;
+      case 1:
+        intdict_remove_head(&dict, intdict_count(&dict) > 2 ? 2 : 0);
+        break;
+      default:
+        assert(intdict_insert(&dict, key, NULL, NULL));
+        break;
+    }
+
+    if (step == NumberOfSteps / 2) {
+      assert(intdict_index_sums(&dict));
+      assert(intdict_index_sums(&dict));
+    }
+    check_sums(&dict);
+  }
+
+  for (IntDictKey key = KeyRange; key < KeyRange * 2; ++key) {
+    assert(intdict_append(&dict, key, NULL));
+  }
+  check_sums(&dict);
+
+  intdict_destroy(&dict, NULL, NULL);
+}
+
+static void test71(void)
+{
+  /* Sum range of negative keys with an index created when empty */
+  IntDict dict;
+  intdict_init(&dict);
+  assert(intdict_index_sums(&dict));
+  assert(intdict_sum_range(&dict, INTDICTKEY_MIN, INTDICTKEY_MAX) == 0);
+
+  for (int i = 0; i < NumberOfItems * NumberOfDuplicates; ++i) {
+    assert(intdict_insert(&dict, -i, NULL, NULL));
+  }
+  check_sums(&dict);
+
+  while (intdict_count(&dict) > 0) {
+    intdict_remove_head(&dict, 1);
+    check_sums(&dict);
+  }
+
+  intdict_destroy(&dict, NULL, NULL);
+}
+
 void intdict_tests(void)
 {
   static const struct
@@ -1479,6 +1862,17 @@ void intdict_tests(void)
     { "Remove key from tail without position", test58 },
     { "Remove key from middle without position", test59 },
     { "Remove key with null value without position", test60 },
+    { "Store small values inline", test61 },
+    { "Store structs inline", test62 },
+    { "Remove values stored inline", test63 },
+    { "Destroy values stored inline", test64 },
+    { "Append in ascending order", test65 },
+    { "Insert in ascending order", test66 },
+    { "Sliding window", test67 },
+    { "Remove head", test68 },
+    { "Rank, count range and quantile", test69 },
+    { "Sum range", test70 },
+    { "Sum range with an index", test71 },
   };
 
   for (size_t count = 0; count < ARRAY_SIZE(unit_tests); count ++)
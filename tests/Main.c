@@ -39,6 +39,13 @@ int main(int argc, char *argv[])
     { "FileRWInt", FileRWInt_tests },
     { "IntDict", intdict_tests },
     { "StrDict", strdict_tests },
+    { "SortedDict", SortedDict_tests },
+    { "StrExtra", StrExtra_tests },
+    { "CSV", CSV_tests },
+    { "TrigTable", TrigTable_tests },
+    { "ArgUtils", ArgUtils_tests },
+    { "ThreadPool", ThreadPool_tests },
+    { "ByteRing", ByteRing_tests },
   };
 
   NOT_USED(argc);
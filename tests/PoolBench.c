@@ -0,0 +1,195 @@
+/*
+ * CBUtilLib benchmark: Pool of threads for running loops in parallel
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* Measures how the time taken to run a parallel loop and a recursive
+   fork/join computation scales with the number of threads in a pool.
+   The first command-line argument, if any, is the maximum number of
+   threads. This program is not run as part of the unit tests. */
+
+/* ISO library headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* CBUtilLib headers */
+#include "ThreadPool.h"
+
+enum
+{
+  DefaultMaxThreads = 8,
+  NumberOfIndices = 1 << 22,
+  InnerLoopCount = 64,
+  LeafSize = 1024,
+  Repeats = 5,
+};
+
+typedef struct
+{
+  ThreadPool   *pool;
+  size_t        start, end;
+  double        sum;
+}
+SumTask;
+
+static double get_time(void)
+{
+  struct timespec ts;
+  if (!timespec_get(&ts, TIME_UTC))
+  {
+    return (double)clock() / CLOCKS_PER_SEC;
+  }
+  return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+static double work(size_t const i)
+{
+  /* Enough arithmetic per index to be worth parallelizing */
+  double x = (double)i;
+  for (int j = 0; j < InnerLoopCount; ++j)
+  {
+    x = (x * 0.5) + 1.0;
+  }
+  return x;
+}
+
+static void sum_range(size_t const start, size_t const end,
+                      void *const partial, void *const arg)
+{
+  double *const sum = partial;
+  (void)arg;
+
+  for (size_t i = start; i < end; ++i)
+  {
+    *sum += work(i);
+  }
+}
+
+static void add_sums(void *const result, const void *const partial,
+                     void *const arg)
+{
+  double *const sum = result;
+  const double *const partial_sum = partial;
+  (void)arg;
+  *sum += *partial_sum;
+}
+
+static void sum_task(void *const arg)
+{
+  SumTask *const task = arg;
+
+  task->sum = 0;
+  if (task->end - task->start <= LeafSize)
+  {
+    sum_range(task->start, task->end, &task->sum, NULL);
+    return;
+  }
+
+  size_t const mid = task->start + ((task->end - task->start) / 2);
+  SumTask lower = {.pool = task->pool, .start = task->start, .end = mid};
+  SumTask upper = {.pool = task->pool, .start = mid, .end = task->end};
+  ThreadPoolGroup group;
+  threadpool_group_init(&group);
+  threadpool_fork(task->pool, &group, sum_task, &upper);
+  sum_task(&lower);
+  threadpool_join(task->pool, &group);
+  task->sum = lower.sum + upper.sum;
+}
+
+static double time_for(ThreadPool *const pool, double *const sum)
+{
+  ThreadPoolReduction const reduction = {
+    .result = sum, .size = sizeof(*sum), .reduce = add_sums
+  };
+  double const start = get_time();
+  *sum = 0;
+  if (!threadpool_for(pool, 0, NumberOfIndices, sum_range, NULL,
+                      &reduction))
+  {
+    fputs("Parallel loop failed\n", stderr);
+    exit(EXIT_FAILURE);
+  }
+  return get_time() - start;
+}
+
+static double time_fork(ThreadPool *const pool, double *const sum)
+{
+  SumTask task = {.pool = pool, .start = 0, .end = NumberOfIndices};
+  double const start = get_time();
+  sum_task(&task);
+  *sum = task.sum;
+  return get_time() - start;
+}
+
+static double best_of(ThreadPool *const pool,
+                      double (*const fn)(ThreadPool *, double *),
+                      double *const sum)
+{
+  double best = 0;
+  for (int i = 0; i < Repeats; ++i)
+  {
+    double const t = fn(pool, sum);
+    if (i == 0 || t < best)
+    {
+      best = t;
+    }
+  }
+  return best;
+}
+
+int main(int argc, char *argv[])
+{
+  size_t max_threads = DefaultMaxThreads;
+  if (argc > 1)
+  {
+    max_threads = strtoul(argv[1], NULL, 10);
+  }
+
+  printf("%8s %8s %12s %8s %12s %8s\n", "threads", "workers", "for (s)",
+         "speedup", "fork (s)", "speedup");
+
+  double for_base = 0, fork_base = 0;
+  for (size_t nthreads = 0; nthreads <= max_threads; ++nthreads)
+  {
+    ThreadPool *const pool = threadpool_make(nthreads);
+    if (pool == NULL)
+    {
+      fputs("Failed to make a pool\n", stderr);
+      return EXIT_FAILURE;
+    }
+
+    double for_sum, fork_sum;
+    double const for_time = best_of(pool, time_for, &for_sum);
+    double const fork_time = best_of(pool, time_fork, &fork_sum);
+    if (nthreads == 0)
+    {
+      for_base = for_time;
+      fork_base = fork_time;
+    }
+
+    printf("%8zu %8zu %12.4f %8.2f %12.4f %8.2f\n", nthreads,
+           threadpool_get_nworkers(pool), for_time, for_base / for_time,
+           fork_time, fork_base / fork_time);
+
+    /* Sums are printed to stop the work being optimized away */
+    fprintf(stderr, "%g %g\n", for_sum, fork_sum);
+    threadpool_destroy(pool);
+  }
+
+  return EXIT_SUCCESS;
+}
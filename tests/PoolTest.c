@@ -0,0 +1,421 @@
+/*
+ * CBUtilLib test: Pool of threads for running loops in parallel
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* ISO library headers */
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+
+/* CBUtilLib headers */
+#include "ThreadPool.h"
+#include "IntDict.h"
+#include "StrDict.h"
+
+/* Local headers */
+#include "Tests.h"
+
+enum
+{
+  NumberOfIndices = 100000,
+  MaxThreads = 4,
+  StartIndex = 10,
+  NumberOfItems = 10000,
+  MinKey = 1000,
+  MaxKey = 8999,
+  LeafSize = 64,
+  NumberOfRows = 200,
+  NumberOfColumns = 500,
+};
+
+typedef struct
+{
+  ThreadPool         *pool;
+  size_t              start, end;
+  unsigned long long  sum;
+}
+SumTask;
+
+typedef struct
+{
+  unsigned char visits[NumberOfIndices];
+}
+VisitArgs;
+
+static void count_visits(size_t const start, size_t const end,
+                         void *const partial, void *const arg)
+{
+  VisitArgs *const args = arg;
+  assert(partial == NULL);
+  assert(start < end);
+  assert(end <= NumberOfIndices);
+
+  /* Each element is only written by the thread that owns its chunk */
+  for (size_t i = start; i < end; ++i)
+  {
+    args->visits[i]++;
+  }
+}
+
+static void sum_indices(size_t const start, size_t const end,
+                        void *const partial, void *const arg)
+{
+  unsigned long long *const sum = partial;
+  assert(sum != NULL);
+  NOT_USED(arg);
+
+  for (size_t i = start; i < end; ++i)
+  {
+    *sum += i;
+  }
+}
+
+static void add_sums(void *const result, const void *const partial,
+                     void *const arg)
+{
+  unsigned long long *const sum = result;
+  const unsigned long long *const partial_sum = partial;
+  NOT_USED(arg);
+  *sum += *partial_sum;
+}
+
+static void sum_keys(size_t const start, size_t const end,
+                     void *const partial, void *const arg)
+{
+  IntDict *const dict = arg;
+  unsigned long long *const sum = partial;
+
+  for (size_t i = start; i < end; ++i)
+  {
+    *sum += (unsigned long long)intdict_get_key_at(dict, i);
+  }
+}
+
+static void count_vowels(size_t const start, size_t const end,
+                         void *const partial, void *const arg)
+{
+  StrDict *const dict = arg;
+  unsigned long long *const count = partial;
+
+  for (size_t i = start; i < end; ++i)
+  {
+    if (strchr("aeiou", *strdict_get_key_at(dict, i)) != NULL)
+    {
+      ++*count;
+    }
+  }
+}
+
+static void sum_task(void *const arg)
+{
+  /* Recursively fork a task for the upper half of the range */
+  SumTask *const task = arg;
+  assert(task != NULL);
+
+  task->sum = 0;
+  if (task->end - task->start <= LeafSize)
+  {
+    for (size_t i = task->start; i < task->end; ++i)
+    {
+      task->sum += i;
+    }
+    return;
+  }
+
+  size_t const mid = task->start + ((task->end - task->start) / 2);
+  SumTask lower = {.pool = task->pool, .start = task->start, .end = mid};
+  SumTask upper = {.pool = task->pool, .start = mid, .end = task->end};
+  ThreadPoolGroup group;
+  threadpool_group_init(&group);
+  threadpool_fork(task->pool, &group, sum_task, &upper);
+  sum_task(&lower);
+  threadpool_join(task->pool, &group);
+  task->sum = lower.sum + upper.sum;
+}
+
+static void sum_columns(size_t const start, size_t const end,
+                        void *const partial, void *const arg)
+{
+  unsigned long long *const sum = partial;
+  size_t const *const row = arg;
+
+  for (size_t i = start; i < end; ++i)
+  {
+    *sum += (*row * NumberOfColumns) + i;
+  }
+}
+
+static void sum_rows(size_t const start, size_t const end,
+                     void *const partial, void *const arg)
+{
+  /* Loop over the columns of each row in parallel */
+  unsigned long long *const sum = partial;
+  ThreadPool *const pool = arg;
+
+  for (size_t row = start; row < end; ++row)
+  {
+    unsigned long long row_sum = 0;
+    ThreadPoolReduction const reduction = {
+      .result = &row_sum, .size = sizeof(row_sum), .reduce = add_sums
+    };
+    size_t row_arg = row;
+    assert(threadpool_for(pool, 0, NumberOfColumns, sum_columns, &row_arg,
+                          &reduction));
+    *sum += row_sum;
+  }
+}
+
+static void test1(void)
+{
+  /* Make and destroy */
+  for (size_t nthreads = 0; nthreads <= MaxThreads; ++nthreads)
+  {
+    ThreadPool *const pool = threadpool_make(nthreads);
+    assert(pool != NULL);
+    size_t const nworkers = threadpool_get_nworkers(pool);
+    assert(nworkers >= 1);
+    assert(nworkers <= nthreads + 1);
+    threadpool_destroy(pool);
+  }
+
+  assert(threadpool_get_nworkers(NULL) == 1);
+  threadpool_destroy(NULL);
+}
+
+static void test2(void)
+{
+  /* Each index is visited once */
+  static VisitArgs args;
+
+  for (size_t nthreads = 0; nthreads <= MaxThreads; ++nthreads)
+  {
+    ThreadPool *const pool = threadpool_make(nthreads);
+    assert(pool != NULL);
+
+    /* Repeat to check that the threads are reused */
+    for (size_t end = StartIndex; end <= NumberOfIndices; end *= 10)
+    {
+      memset(&args, 0, sizeof(args));
+      assert(threadpool_for(pool, StartIndex, end, count_visits, &args,
+                            NULL));
+
+      for (size_t i = 0; i < NumberOfIndices; ++i)
+      {
+        assert(args.visits[i] == (i >= StartIndex && i < end ? 1 : 0));
+      }
+    }
+
+    threadpool_destroy(pool);
+  }
+}
+
+static void test3(void)
+{
+  /* Reduction */
+  for (size_t nthreads = 0; nthreads <= MaxThreads; ++nthreads)
+  {
+    ThreadPool *const pool = threadpool_make(nthreads);
+    assert(pool != NULL);
+
+    for (size_t end = 0; end <= NumberOfIndices; end = end * 10 + 1)
+    {
+      unsigned long long sum = 0;
+      ThreadPoolReduction const reduction = {
+        .result = &sum, .size = sizeof(sum), .reduce = add_sums
+      };
+      assert(threadpool_for(pool, 0, end, sum_indices, NULL, &reduction));
+      assert(sum == (unsigned long long)end * (end > 0 ? end - 1 : 0) / 2);
+    }
+
+    threadpool_destroy(pool);
+  }
+}
+
+static void test4(void)
+{
+  /* Without a pool */
+  static VisitArgs args;
+  memset(&args, 0, sizeof(args));
+  assert(threadpool_for(NULL, 0, NumberOfIndices, count_visits, &args,
+                        NULL));
+  for (size_t i = 0; i < NumberOfIndices; ++i)
+  {
+    assert(args.visits[i] == 1);
+  }
+}
+
+static void test5(void)
+{
+  /* Integer dictionary range */
+  IntDict dict;
+  intdict_init(&dict);
+  for (IntDictKey key = 0; key < NumberOfItems; ++key)
+  {
+    assert(intdict_append(&dict, key, NULL));
+  }
+
+  ThreadPool *const pool = threadpool_make(MaxThreads);
+  assert(pool != NULL);
+
+  unsigned long long sum = 0;
+  ThreadPoolReduction const reduction = {
+    .result = &sum, .size = sizeof(sum), .reduce = add_sums
+  };
+  assert(intdict_parallel_for_range(&dict, MinKey, MaxKey, pool, sum_keys,
+                                    &dict, &reduction));
+  assert(sum == (unsigned long long)(MinKey + MaxKey) *
+                (MaxKey - MinKey + 1) / 2);
+
+  sum = 0;
+  assert(intdict_parallel_for_range(&dict, MaxKey, MinKey, pool, sum_keys,
+                                    &dict, &reduction));
+  assert(sum == 0);
+
+  threadpool_destroy(pool);
+  intdict_destroy(&dict, NULL, NULL);
+}
+
+static void test6(void)
+{
+  /* String dictionary range */
+  static const char *const keys[] = {
+    "apple", "banana", "cherry", "damson", "elderberry", "fig", "grape",
+    "huckleberry", "imbe", "jackfruit", "kiwi", "lemon", "mango",
+    "nectarine", "orange", "peach", "quince", "raspberry"
+  };
+
+  StrDict dict;
+  strdict_init(&dict);
+  for (size_t i = 0; i < ARRAY_SIZE(keys); ++i)
+  {
+    assert(strdict_append(&dict, keys[i], NULL));
+  }
+
+  ThreadPool *const pool = threadpool_make(MaxThreads);
+  assert(pool != NULL);
+
+  unsigned long long count = 0;
+  ThreadPoolReduction const reduction = {
+    .result = &count, .size = sizeof(count), .reduce = add_sums
+  };
+  assert(strdict_parallel_for_range(&dict, "b", "p", pool, count_vowels,
+                                    &dict, &reduction));
+  assert(count == 3); /* elderberry, imbe, orange */
+
+  threadpool_destroy(pool);
+  strdict_destroy(&dict, NULL, NULL);
+}
+
+static void test7(void)
+{
+  /* Fork and join */
+  for (size_t nthreads = 0; nthreads <= MaxThreads; ++nthreads)
+  {
+    ThreadPool *const pool = threadpool_make(nthreads);
+    assert(pool != NULL);
+
+    for (size_t end = 0; end <= NumberOfIndices; end = end * 10 + 1)
+    {
+      unsigned long long const expected =
+        (unsigned long long)end * (end > 0 ? end - 1 : 0) / 2;
+      SumTask task = {.pool = pool, .start = 0, .end = end};
+      ThreadPoolGroup group;
+      threadpool_group_init(&group);
+      threadpool_fork(pool, &group, sum_task, &task);
+      threadpool_join(pool, &group);
+      assert(task.sum == expected);
+
+      /* Reuse the group */
+      task.sum = 0;
+      threadpool_fork(pool, &group, sum_task, &task);
+      threadpool_join(pool, &group);
+      assert(task.sum == expected);
+    }
+
+    threadpool_destroy(pool);
+  }
+}
+
+static void test8(void)
+{
+  /* Fork and join without a pool */
+  SumTask task = {.pool = NULL, .start = 0, .end = NumberOfIndices};
+  ThreadPoolGroup group;
+  threadpool_group_init(&group);
+  threadpool_fork(NULL, &group, sum_task, &task);
+  assert(task.sum == (unsigned long long)NumberOfIndices *
+                     (NumberOfIndices - 1) / 2);
+  threadpool_join(NULL, &group);
+}
+
+static void test9(void)
+{
+  /* Nested loops */
+  unsigned long long const n = (unsigned long long)NumberOfRows *
+                               NumberOfColumns;
+
+  for (size_t nthreads = 0; nthreads <= MaxThreads; ++nthreads)
+  {
+    ThreadPool *const pool = threadpool_make(nthreads);
+    assert(pool != NULL);
+
+    unsigned long long sum = 0;
+    ThreadPoolReduction const reduction = {
+      .result = &sum, .size = sizeof(sum), .reduce = add_sums
+    };
+    assert(threadpool_for(pool, 0, NumberOfRows, sum_rows, pool,
+                          &reduction));
+    assert(sum == n * (n - 1) / 2);
+
+    threadpool_destroy(pool);
+  }
+}
+
+void ThreadPool_tests(void)
+{
+  static const struct
+  {
+    const char *test_name;
+    void (*test_func)(void);
+  }
+  unit_tests[] =
+  {
+    { "Make and destroy", test1 },
+    { "Visit each index once", test2 },
+    { "Reduction", test3 },
+    { "Without a pool", test4 },
+    { "Integer dictionary range", test5 },
+    { "String dictionary range", test6 },
+    { "Fork and join", test7 },
+    { "Fork and join without a pool", test8 },
+    { "Nested loops", test9 },
+  };
+
+  for (size_t count = 0; count < ARRAY_SIZE(unit_tests); count ++)
+  {
+    printf("Test %zu/%zu : %s\n",
+           1 + count,
+           ARRAY_SIZE(unit_tests),
+           unit_tests[count].test_name);
+
+    unit_tests[count].test_func();
+  }
+}
@@ -0,0 +1,336 @@
+/*
+ * CBUtilLib test: Single-producer, single-consumer ring buffer of bytes
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* ISO library headers */
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+/* CBUtilLib headers */
+#include "ByteRing.h"
+#include "ThreadPool.h"
+#include "StringBuff.h"
+
+/* Local headers */
+#include "Tests.h"
+
+enum
+{
+  Capacity = 64,
+  MaxAppend = 16,
+  NumberOfMessages = 2000,
+  MaxMessageLen = 12,
+};
+
+static size_t drain(ByteRing *const ring, char *const out,
+                    size_t const out_size)
+{
+  /* Consume everything in a ring, copying it into an array */
+  size_t len = 0;
+  const char *data;
+  size_t count;
+
+  while ((count = bytering_get_data(ring, &data)) > 0)
+  {
+    assert(len + count <= out_size);
+    memcpy(out + len, data, count);
+    len += count;
+    bytering_consume(ring, count);
+  }
+  return len;
+}
+
+static void produce(void *const arg)
+{
+  /* Append numbered messages, waiting for space when the ring is full */
+  ByteRing *const ring = arg;
+
+  for (size_t i = 0; i < NumberOfMessages; ++i)
+  {
+    while (!bytering_printf(ring, "%zu\n", i))
+    {
+    }
+  }
+}
+
+static void test1(void)
+{
+  /* Make and destroy */
+  ByteRing *const ring = bytering_make(Capacity - 1, MaxAppend);
+  assert(ring != NULL);
+
+  const char *data;
+  assert(bytering_get_data(ring, &data) == 0);
+  bytering_destroy(ring);
+  bytering_destroy(NULL);
+}
+
+static void test2(void)
+{
+  /* Append and consume */
+  ByteRing *const ring = bytering_make(Capacity, MaxAppend);
+  assert(ring != NULL);
+
+  assert(bytering_append(ring, "hello", strlen("hello")));
+  assert(bytering_append(ring, NULL, 0));
+  assert(bytering_printf(ring, " %s %d", "world", 42));
+
+  const char *data;
+  size_t const count = bytering_get_data(ring, &data);
+  assert(count == strlen("hello world 42"));
+  assert(memcmp(data, "hello world 42", count) == 0);
+
+  bytering_consume(ring, strlen("hello "));
+  assert(bytering_get_data(ring, &data) == strlen("world 42"));
+  assert(memcmp(data, "world 42", strlen("world 42")) == 0);
+
+  bytering_consume(ring, strlen("world 42"));
+  assert(bytering_get_data(ring, &data) == 0);
+
+  bytering_destroy(ring);
+}
+
+static void test3(void)
+{
+  /* Prepare and finish */
+  ByteRing *const ring = bytering_make(Capacity, MaxAppend);
+  assert(ring != NULL);
+
+  size_t min_size = MaxAppend + 1;
+  assert(bytering_prepare_append(ring, &min_size) == NULL);
+
+  min_size = 4;
+  char *const free_ptr = bytering_prepare_append(ring, &min_size);
+  assert(free_ptr != NULL);
+  assert(min_size >= 4);
+  assert(min_size <= Capacity);
+  strcpy(free_ptr, "abc");
+  bytering_finish_append(ring, strlen("abc"));
+
+  /* Nothing is appended if finished with no bytes */
+  min_size = 1;
+  assert(bytering_prepare_append(ring, &min_size) != NULL);
+  bytering_finish_append(ring, 0);
+
+  char out[Capacity];
+  assert(drain(ring, out, sizeof(out)) == strlen("abc"));
+  assert(memcmp(out, "abc", strlen("abc")) == 0);
+
+  bytering_destroy(ring);
+}
+
+static void test4(void)
+{
+  /* Full */
+  ByteRing *const ring = bytering_make(Capacity, MaxAppend);
+  assert(ring != NULL);
+
+  static const char data[MaxAppend] = "0123456789abcdef";
+  for (size_t i = 0; i < Capacity / MaxAppend; ++i)
+  {
+    assert(bytering_append(ring, data, sizeof(data)));
+  }
+  assert(!bytering_append(ring, data, 1));
+  assert(!bytering_printf(ring, "x"));
+
+  /* Space is available again after consuming some bytes */
+  const char *out;
+  assert(bytering_get_data(ring, &out) == Capacity);
+  bytering_consume(ring, 1);
+  assert(!bytering_printf(ring, "x")); /* No space for a nul terminator */
+  assert(bytering_append(ring, "x", 1));
+  assert(!bytering_append(ring, data, 1));
+
+  bytering_destroy(ring);
+}
+
+static void test5(void)
+{
+  /* Wrap around */
+  ByteRing *const ring = bytering_make(Capacity, MaxAppend);
+  assert(ring != NULL);
+
+  /* Appending a number of bytes that has no common factor with the
+     capacity leaves every possible gap at the end of the ring. */
+  for (int i = 0; i < Capacity * 4; ++i)
+  {
+    char expected[MaxAppend];
+    int const len = sprintf(expected, "%.7d", i);
+    assert(len == 7);
+
+    /* The formatted string may overhang the end of the ring */
+    assert(bytering_printf(ring, "%.7d", i));
+
+    char out[Capacity];
+    assert(drain(ring, out, sizeof(out)) == (size_t)len);
+    assert(memcmp(out, expected, (size_t)len) == 0);
+  }
+
+  bytering_destroy(ring);
+}
+
+static void test6(void)
+{
+  /* Write to a file */
+  ByteRing *const ring = bytering_make(Capacity, MaxAppend);
+  assert(ring != NULL);
+
+  FILE *const f = tmpfile();
+  assert(f != NULL);
+
+  StringBuffer expected;
+  stringbuffer_init(&expected);
+
+  for (size_t i = 0; i < NumberOfMessages / 10; ++i)
+  {
+    if (!bytering_printf(ring, "%zu,", i))
+    {
+      assert(bytering_fwrite(ring, f));
+      assert(bytering_printf(ring, "%zu,", i));
+    }
+    assert(stringbuffer_printf(&expected, "%zu,", i));
+  }
+  assert(bytering_fwrite(ring, f));
+  assert(bytering_fwrite(ring, f)); /* Nothing to write */
+
+  size_t const len = stringbuffer_get_length(&expected);
+  char *const out = malloc(len + 1);
+  assert(out != NULL);
+
+  rewind(f);
+  assert(fread(out, 1, len + 1, f) == len);
+  assert(memcmp(out, stringbuffer_get_pointer(&expected), len) == 0);
+
+  free(out);
+  fclose(f);
+  stringbuffer_destroy(&expected);
+  bytering_destroy(ring);
+}
+
+static void test7(void)
+{
+  /* Concurrent producer and consumer */
+  ThreadPool *const pool = threadpool_make(1);
+  assert(pool != NULL);
+
+  /* The producer would never finish if it couldn't run concurrently */
+  if (threadpool_get_nworkers(pool) > 1)
+  {
+    ByteRing *const ring = bytering_make(Capacity, MaxAppend);
+    assert(ring != NULL);
+
+    ThreadPoolGroup group;
+    threadpool_group_init(&group);
+    threadpool_fork(pool, &group, produce, ring);
+
+    char line[MaxMessageLen];
+    size_t line_len = 0, next = 0;
+
+    while (next < NumberOfMessages)
+    {
+      const char *data;
+      size_t const count = bytering_get_data(ring, &data);
+
+      for (size_t i = 0; i < count; ++i)
+      {
+        if (data[i] == '\n')
+        {
+          line[line_len] = '\0';
+          assert(strtoul(line, NULL, 10) == next);
+          ++next;
+          line_len = 0;
+        }
+        else
+        {
+          assert(line_len < sizeof(line) - 1);
+          line[line_len++] = data[i];
+        }
+      }
+      bytering_consume(ring, count);
+    }
+
+    threadpool_join(pool, &group);
+
+    const char *data;
+    assert(bytering_get_data(ring, &data) == 0);
+    bytering_destroy(ring);
+  }
+
+  threadpool_destroy(pool);
+}
+
+static void test8(void)
+{
+  /* Appending more than the maximum fails at every position */
+  ByteRing *const ring = bytering_make(Capacity, MaxAppend);
+  assert(ring != NULL);
+
+  for (int i = 0; i < Capacity; ++i)
+  {
+    size_t min_size = 1;
+    assert(bytering_prepare_append(ring, &min_size) != NULL);
+    assert(min_size <= MaxAppend);
+    bytering_finish_append(ring, 0);
+
+    /* A nul terminator must fit too */
+    assert(!bytering_printf(ring, "%0*d", MaxAppend, i));
+    assert(bytering_printf(ring, "%0*d", MaxAppend - 1, i));
+
+    char out[Capacity];
+    assert(drain(ring, out, sizeof(out)) == MaxAppend - 1);
+
+    /* Move to the next position */
+    assert(bytering_append(ring, "x", 1));
+    assert(drain(ring, out, sizeof(out)) == 1);
+  }
+
+  bytering_destroy(ring);
+}
+
+void ByteRing_tests(void)
+{
+  static const struct
+  {
+    const char *test_name;
+    void (*test_func)(void);
+  }
+  unit_tests[] =
+  {
+    { "Make and destroy", test1 },
+    { "Append and consume", test2 },
+    { "Prepare and finish", test3 },
+    { "Full", test4 },
+    { "Wrap around", test5 },
+    { "Write to a file", test6 },
+    { "Concurrent producer and consumer", test7 },
+    { "Too big at every position", test8 },
+  };
+
+  for (size_t count = 0; count < ARRAY_SIZE(unit_tests); count ++)
+  {
+    printf("Test %zu/%zu : %s\n",
+           1 + count,
+           ARRAY_SIZE(unit_tests),
+           unit_tests[count].test_name);
+
+    unit_tests[count].test_func();
+  }
+}
@@ -0,0 +1,315 @@
+/*
+ * CBUtilLib test: Type-specialised sorted dictionary
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* ISO library headers */
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <limits.h>
+#include <assert.h>
+
+/* CBUtilLib headers */
+#include "SortedDict.h"
+
+/* Local headers */
+#include "Tests.h"
+
+enum
+{
+  NumberOfItems = 1000,
+  NumberOfDuplicates = 3,
+  RemoveInterval = 3,
+  RangeMin = 100,
+  RangeMax = 199,
+  MissingKey = -1,
+};
+
+typedef struct
+{
+  int x, y;
+}
+Point;
+
+static int compare_int(int const a, int const b)
+{
+  return (a > b) - (a < b);
+}
+
+#define COMPARE_STRINGS(a, b) strcmp(a, b)
+
+SORTEDDICT_DEFINE(PointDict, int, Point, compare_int)
+SORTEDDICT_DEFINE(NameDict, const char *, int, COMPARE_STRINGS)
+
+static void check_sorted(PointDict const *const dict)
+{
+  for (size_t i = 1; i < PointDict_count(dict); ++i)
+  {
+    assert(PointDict_get_key_at(dict, i - 1) <=
+           PointDict_get_key_at(dict, i));
+  }
+}
+
+static void test1(void)
+{
+  /* Insert in descending order and find */
+  PointDict dict;
+  PointDict_init(&dict);
+  assert(PointDict_count(&dict) == 0);
+  assert(!PointDict_find(&dict, 0, NULL));
+
+  for (int i = NumberOfItems - 1; i >= 0; --i)
+  {
+    size_t index = SIZE_MAX;
+    assert(PointDict_insert(&dict, i, (Point){i, -i}, &index));
+    assert(index == 0);
+  }
+  assert(PointDict_count(&dict) == NumberOfItems);
+  check_sorted(&dict);
+
+  for (int i = 0; i < NumberOfItems; ++i)
+  {
+    size_t index;
+    Point *const p = PointDict_find_value(&dict, i, &index);
+    assert(p != NULL);
+    assert(index == (size_t)i);
+    assert(p->x == i);
+    assert(p->y == -i);
+    assert(p == PointDict_get_value_at(&dict, index));
+  }
+  assert(PointDict_find_value(&dict, MissingKey, NULL) == NULL);
+  assert(PointDict_find_value(&dict, NumberOfItems, NULL) == NULL);
+
+  PointDict_destroy(&dict);
+}
+
+static void test2(void)
+{
+  /* Modify values in place */
+  PointDict dict;
+  PointDict_init(&dict);
+
+  for (int i = 0; i < NumberOfItems; ++i)
+  {
+    assert(PointDict_insert(&dict, i, (Point){0, 0}, NULL));
+  }
+
+  SORTEDDICT_FOR_EACH(PointDict, &dict, i, tmp)
+  {
+    PointDict_get_value_at(&dict, i)->x = PointDict_get_key_at(&dict, i);
+  }
+
+  for (int i = 0; i < NumberOfItems; ++i)
+  {
+    assert(PointDict_find_value(&dict, i, NULL)->x == i);
+  }
+
+  PointDict_destroy(&dict);
+}
+
+static void test3(void)
+{
+  /* Duplicates are inserted after equal keys */
+  PointDict dict;
+  PointDict_init(&dict);
+
+  for (int d = 0; d < NumberOfDuplicates; ++d)
+  {
+    for (int i = 0; i < NumberOfItems; ++i)
+    {
+      size_t index;
+      assert(PointDict_insert(&dict, i, (Point){i, d}, &index));
+      assert(PointDict_get_value_at(&dict, index)->y == d);
+    }
+  }
+  assert(PointDict_count(&dict) == NumberOfItems * NumberOfDuplicates);
+  check_sorted(&dict);
+
+  for (int i = 0; i < NumberOfItems; ++i)
+  {
+    size_t const left = PointDict_bisect_left(&dict, i);
+    size_t const right = PointDict_bisect_right(&dict, i);
+    assert(left == (size_t)i * NumberOfDuplicates);
+    assert(right - left == NumberOfDuplicates);
+
+    for (size_t j = left; j < right; ++j)
+    {
+      assert(PointDict_get_value_at(&dict, j)->y == (int)(j - left));
+    }
+  }
+
+  PointDict_destroy(&dict);
+}
+
+static void test4(void)
+{
+  /* Iterate over a range */
+  PointDict dict;
+  PointDict_init(&dict);
+
+  for (int i = 0; i < NumberOfItems; ++i)
+  {
+    assert(PointDict_insert(&dict, i * 2, (Point){i, i}, NULL));
+  }
+
+  int count = 0, expected = RangeMin;
+  SORTEDDICT_FOR_EACH_IN_RANGE(PointDict, &dict, RangeMin, RangeMax, i, tmp)
+  {
+    int const key = PointDict_get_key_at(&dict, i);
+    assert(key == expected);
+    assert(key >= RangeMin && key <= RangeMax);
+    expected += 2;
+    ++count;
+  }
+  assert(count == ((RangeMax - RangeMin) / 2) + 1);
+
+  PointDict_destroy(&dict);
+}
+
+static void test5(void)
+{
+  /* Remove */
+  PointDict dict;
+  PointDict_init(&dict);
+
+  for (int i = 0; i < NumberOfItems; ++i)
+  {
+    assert(PointDict_insert(&dict, i, (Point){i, i}, NULL));
+  }
+
+  assert(!PointDict_remove(&dict, MissingKey, NULL));
+
+  size_t nremoved = 0;
+  for (int i = 0; i < NumberOfItems; i += RemoveInterval)
+  {
+    size_t index;
+    assert(PointDict_remove(&dict, i, &index));
+    assert(index == (size_t)i - nremoved);
+    ++nremoved;
+  }
+  assert(PointDict_count(&dict) == NumberOfItems - nremoved);
+  check_sorted(&dict);
+
+  for (int i = 0; i < NumberOfItems; ++i)
+  {
+    Point *const p = PointDict_find_value(&dict, i, NULL);
+    if (i % RemoveInterval == 0)
+    {
+      assert(p == NULL);
+    }
+    else
+    {
+      assert(p != NULL);
+      assert(p->x == i);
+    }
+  }
+
+  while (PointDict_count(&dict) > 0)
+  {
+    PointDict_remove_at(&dict, PointDict_count(&dict) - 1);
+  }
+
+  PointDict_destroy(&dict);
+}
+
+static void test6(void)
+{
+  /* String keys */
+  static const char *const names[] = {"Mercury", "Venus", "Earth", "Mars",
+                                      "Jupiter", "Saturn", "Uranus"};
+  NameDict dict;
+  NameDict_init(&dict);
+
+  for (size_t i = 0; i < ARRAY_SIZE(names); ++i)
+  {
+    assert(NameDict_insert(&dict, names[i], (int)i, NULL));
+  }
+
+  for (size_t i = 1; i < NameDict_count(&dict); ++i)
+  {
+    assert(strcmp(NameDict_get_key_at(&dict, i - 1),
+                  NameDict_get_key_at(&dict, i)) < 0);
+  }
+
+  for (size_t i = 0; i < ARRAY_SIZE(names); ++i)
+  {
+    char key[16];
+    strcpy(key, names[i]);
+    int *const value = NameDict_find_value(&dict, key, NULL);
+    assert(value != NULL);
+    assert(*value == (int)i);
+  }
+  assert(NameDict_find_value(&dict, "Pluto", NULL) == NULL);
+
+  NameDict_destroy(&dict);
+}
+
+static void test7(void)
+{
+  /* Insert fail recovery */
+  for (unsigned long limit = 0; limit < 4; ++limit)
+  {
+    PointDict dict;
+    PointDict_init(&dict);
+    Fortify_SetNumAllocationsLimit(limit);
+
+    int i;
+    for (i = 0; i < NumberOfItems; ++i)
+    {
+      if (!PointDict_insert(&dict, i, (Point){i, i}, NULL))
+      {
+        break;
+      }
+    }
+    Fortify_SetNumAllocationsLimit(ULONG_MAX);
+
+    assert(PointDict_count(&dict) == (size_t)i);
+    check_sorted(&dict);
+    PointDict_destroy(&dict);
+  }
+}
+
+void SortedDict_tests(void)
+{
+  static const struct
+  {
+    const char *test_name;
+    void (*test_func)(void);
+  }
+  unit_tests[] =
+  {
+    { "Insert and find", test1 },
+    { "Modify values in place", test2 },
+    { "Insert duplicates", test3 },
+    { "Iterate over a range", test4 },
+    { "Remove", test5 },
+    { "String keys", test6 },
+    { "Insert fail recovery", test7 },
+  };
+
+  for (size_t count = 0; count < ARRAY_SIZE(unit_tests); count ++)
+  {
+    printf("Test %zu/%zu : %s\n",
+           1 + count,
+           ARRAY_SIZE(unit_tests),
+           unit_tests[count].test_name);
+
+    unit_tests[count].test_func();
+  }
+}
@@ -26,6 +26,7 @@
 
 /* CBUtilLib headers */
 #include "StringBuff.h"
+#include "StrExtra.h"
 
 /* Local headers */
 #include "Tests.h"
@@ -786,6 +787,226 @@ static void test23(void)
 #endif
 }
 
+static void test24(void)
+{
+  /* Append inflated string */
+  StringBuffer buffer;
+  static const char srch[] = "<&>";
+  static const char *rplc[] = { "&lt;", "&amp;", "&gt;" };
+  static const struct
+  {
+    const char *tail;
+    const char *expected;
+  }
+  tails[] =
+  {
+    { "a<b", "a&lt;b" },
+    { "", "" },
+    { "plain", "plain" },
+    { "&>", "&amp;&gt;" },
+  };
+  char expected_s[64] = "";
+
+  stringbuffer_init(&buffer);
+
+  for (size_t i = 0; i < ARRAY_SIZE(tails); i++)
+  {
+    const bool success = stringbuffer_append_inflated(&buffer, tails[i].tail,
+                                                      srch, rplc);
+    assert(success);
+
+    strcat(expected_s, tails[i].expected);
+    const size_t len = stringbuffer_get_length(&buffer);
+    assert(len == strlen(expected_s));
+
+    const char *s = stringbuffer_get_pointer(&buffer);
+    assert(strcmp(s, expected_s) == 0);
+  }
+
+  stringbuffer_destroy(&buffer);
+}
+
+static void test25(void)
+{
+  /* Undo append inflated string */
+  StringBuffer buffer;
+  static const char srch[] = "\"";
+  static const char *rplc[] = { "\"\"" };
+
+  stringbuffer_init(&buffer);
+
+  bool success = stringbuffer_append_all(&buffer, "say ");
+  assert(success);
+
+  success = stringbuffer_append_inflated(&buffer, "\"hi\"", srch, rplc);
+  assert(success);
+
+  const char *s = stringbuffer_get_pointer(&buffer);
+  assert(strcmp(s, "say \"\"hi\"\"") == 0);
+
+  stringbuffer_undo(&buffer);
+
+  const size_t len = stringbuffer_get_length(&buffer);
+  assert(len == strlen("say "));
+  s = stringbuffer_get_pointer(&buffer);
+  assert(strcmp(s, "say ") == 0);
+
+  stringbuffer_destroy(&buffer);
+}
+
+static void test26(void)
+{
+#ifdef FORTIFY
+  /* Append inflated string fail recovery */
+  StringBuffer buffer;
+  static const char srch[] = ",";
+  static const char *rplc[] = { "\\," };
+  bool success;
+  size_t len;
+  const char *s;
+
+  stringbuffer_init(&buffer);
+
+  success = stringbuffer_append_inflated(&buffer, "a,b", srch, rplc);
+  assert(success);
+
+  Fortify_SetAllocationLimit(0);
+  success = stringbuffer_append_inflated(&buffer, "c,d", srch, rplc);
+  Fortify_SetAllocationLimit(ULONG_MAX);
+  assert(!success);
+
+  len = stringbuffer_get_length(&buffer);
+  assert(len == 4);
+  s = stringbuffer_get_pointer(&buffer);
+  assert(strcmp(s, "a\\,b") == 0);
+
+  success = stringbuffer_append_inflated(&buffer, "c,d", srch, rplc);
+  assert(success);
+
+  len = stringbuffer_get_length(&buffer);
+  assert(len == 8);
+  s = stringbuffer_get_pointer(&buffer);
+  assert(strcmp(s, "a\\,bc\\,d") == 0);
+
+  stringbuffer_destroy(&buffer);
+#endif
+}
+
+static void test27(void)
+{
+  /* Append deflated string */
+  StringBuffer buffer;
+  static const char *srch[] = { "&lt;", "&amp;", "&gt;" };
+  static const char *rplc[] = { "<", "&", ">" };
+  StrDeflater *const deflater = strdeflater_make(ARRAY_SIZE(srch),
+                                                 srch, rplc);
+  assert(deflater != NULL);
+
+  stringbuffer_init(&buffer);
+
+  bool success = stringbuffer_append_all(&buffer, "x");
+  assert(success);
+
+  success = stringbuffer_append_deflated(&buffer, deflater, "&lt;a&amp;b&gt;");
+  assert(success);
+
+  size_t len = stringbuffer_get_length(&buffer);
+  assert(len == strlen("x<a&b>"));
+  const char *s = stringbuffer_get_pointer(&buffer);
+  assert(strcmp(s, "x<a&b>") == 0);
+
+  stringbuffer_undo(&buffer);
+
+  len = stringbuffer_get_length(&buffer);
+  assert(len == 1);
+  s = stringbuffer_get_pointer(&buffer);
+  assert(strcmp(s, "x") == 0);
+
+  success = stringbuffer_append_deflated(&buffer, deflater, "");
+  assert(success);
+  s = stringbuffer_get_pointer(&buffer);
+  assert(strcmp(s, "x") == 0);
+
+  stringbuffer_destroy(&buffer);
+  strdeflater_destroy(deflater);
+}
+
+static void test28(void)
+{
+  /* Append inflated string using an inflater */
+  StringBuffer buffer;
+  static const char srch[] = "<&>";
+  static const char *rplc[] = { "&lt;", "&amp;", "&gt;" };
+  StrInflater inflater;
+  strinflater_init(&inflater, srch, rplc);
+
+  stringbuffer_init(&buffer);
+
+  bool success = stringbuffer_append_all(&buffer, "x");
+  assert(success);
+
+  success = stringbuffer_append_inflater(&buffer, &inflater, "<a&b>");
+  assert(success);
+
+  size_t len = stringbuffer_get_length(&buffer);
+  assert(len == strlen("x&lt;a&amp;b&gt;"));
+  const char *s = stringbuffer_get_pointer(&buffer);
+  assert(strcmp(s, "x&lt;a&amp;b&gt;") == 0);
+
+  stringbuffer_undo(&buffer);
+
+  len = stringbuffer_get_length(&buffer);
+  assert(len == 1);
+  s = stringbuffer_get_pointer(&buffer);
+  assert(strcmp(s, "x") == 0);
+
+  success = stringbuffer_append_inflater(&buffer, &inflater, "");
+  assert(success);
+  s = stringbuffer_get_pointer(&buffer);
+  assert(strcmp(s, "x") == 0);
+
+  stringbuffer_destroy(&buffer);
+}
+
+static void test29(void)
+{
+  /* Append long inflated string */
+  StringBuffer buffer;
+  static const char srch[] = "<&>";
+  static const char *rplc[] = { "&lt;", "&amp;", "&gt;" };
+  char tail[200];
+  char expected_s[sizeof(tail) * 5];
+
+  for (size_t i = 0; i < sizeof(tail) - 1; i++)
+  {
+    tail[i] = i % 10 == 0 ? srch[(i / 10) % 3] : (char)('a' + (i % 26));
+  }
+  tail[sizeof(tail) - 1] = '\0';
+
+  const size_t expected_len = strinflate(expected_s, sizeof(expected_s),
+                                         tail, srch, rplc);
+  assert(expected_len < sizeof(expected_s));
+
+  stringbuffer_init(&buffer);
+
+  bool success = stringbuffer_append_all(&buffer, "x");
+  assert(success);
+
+  success = stringbuffer_append_inflated(&buffer, tail, srch, rplc);
+  assert(success);
+
+  assert(stringbuffer_get_length(&buffer) == expected_len + 1);
+  const char *s = stringbuffer_get_pointer(&buffer);
+  assert(s[0] == 'x');
+  assert(strcmp(s + 1, expected_s) == 0);
+
+  stringbuffer_undo(&buffer);
+  s = stringbuffer_get_pointer(&buffer);
+  assert(strcmp(s, "x") == 0);
+
+  stringbuffer_destroy(&buffer);
+}
+
 void StringBuffer_tests(void)
 {
   static const struct
@@ -818,6 +1039,12 @@ void StringBuffer_tests(void)
     { "Append separated fail recovery", test21 },
     { "Append formatted", test22 },
     { "Append formatted fail recovery", test23 },
+    { "Append inflated", test24 },
+    { "Undo append inflated", test25 },
+    { "Append inflated fail recovery", test26 },
+    { "Append deflated", test27 },
+    { "Append inflated using an inflater", test28 },
+    { "Append long inflated string", test29 },
   };
 
   for (size_t count = 0; count < ARRAY_SIZE(unit_tests); count ++)
@@ -23,6 +23,7 @@
 #include <string.h>
 #include <stdio.h>
 #include <limits.h>
+#include <stdint.h>
 #include <assert.h>
 
 /* CBUtilLib headers */
@@ -1486,6 +1487,89 @@ static void test60(void)
   remove_null_common(remove_key_only_no_pos);
 }
 
+static void test61(void)
+{
+  /* Append in ascending order */
+  static char const *const keys[] = {"ant", "Bee", "bee", "cat", "Dog"};
+  StrDict dict;
+  strdict_init(&dict);
+
+  for (size_t i = 0; i < ARRAY_SIZE(keys); ++i) {
+    assert(strdict_append(&dict, keys[i], &callbacks[i]));
+    assert(strdict_count(&dict) == i + 1);
+    assert(strdict_get_key_at(&dict, i) == keys[i]);
+    assert(strdict_get_value_at(&dict, i) == &callbacks[i]);
+  }
+
+  size_t index;
+  assert(strdict_find(&dict, "DOG", &index));
+  assert(index == ARRAY_SIZE(keys) - 1);
+  assert(strdict_find(&dict, "BEE", &index));
+  assert(index == 1);
+
+  strdict_destroy(&dict, NULL, NULL);
+}
+
+static void test62(void)
+{
+  /* Insert in ascending order */
+  static char const *const keys[] = {"b", "d", "f", "h", "j", "l"};
+  static char const *const lower_keys[] = {"a", "c", "e", "g", "i", "k"};
+  StrDict dict;
+  strdict_init(&dict);
+
+  for (size_t i = 0; i < ARRAY_SIZE(keys); ++i) {
+    size_t index = SIZE_MAX;
+    assert(strdict_insert(&dict, keys[i], NULL, &index));
+    assert(index == i);
+  }
+
+  /* Insert lower keys after the ascending sequence */
+  for (size_t i = 0; i < ARRAY_SIZE(lower_keys); ++i) {
+    size_t index = SIZE_MAX;
+    assert(strdict_insert(&dict, lower_keys[i], NULL, &index));
+    assert(index == i * 2);
+  }
+
+  STRDICT_FOR_EACH(&dict, i, tmp) {
+    assert(*strdict_get_key_at(&dict, i) == (char)('a' + i));
+  }
+
+  strdict_destroy(&dict, NULL, NULL);
+}
+
+static void test63(void)
+{
+  /* Find after appending reallocates */
+  static char const *const keys[] = {
+    "a", "b", "c", "d", "e", "f", "g", "h", "i", "j", "k", "l", "m", "n",
+    "o", "p", "q", "r", "s", "t", "u", "v", "w", "x", "y", "z"};
+  enum { NumBeforeFind = 4 };
+  StrDict dict;
+  strdict_init(&dict);
+
+  for (size_t i = 0; i < NumBeforeFind; ++i) {
+    assert(strdict_append(&dict, keys[i], NULL));
+  }
+
+  size_t index = SIZE_MAX;
+  assert(strdict_find(&dict, "b", &index));
+  assert(index == 1);
+
+  /* Appending enough keys must move the array at least once */
+  for (size_t i = NumBeforeFind; i < ARRAY_SIZE(keys); ++i) {
+    assert(strdict_append(&dict, keys[i], NULL));
+  }
+
+  index = SIZE_MAX;
+  assert(strdict_find(&dict, "b", &index));
+  assert(index == 1);
+  assert(strdict_find(&dict, "z", &index));
+  assert(index == ARRAY_SIZE(keys) - 1);
+
+  strdict_destroy(&dict, NULL, NULL);
+}
+
 void strdict_tests(void)
 {
   static const struct
@@ -1555,6 +1639,9 @@ void strdict_tests(void)
     { "Remove key from tail without position", test58 },
     { "Remove key from middle without position", test59 },
     { "Remove key with null value without position", test60 },
+    { "Append in ascending order", test61 },
+    { "Insert in ascending order", test62 },
+    { "Find after appending reallocates", test63 },
   };
 
   for (size_t count = 0; count < ARRAY_SIZE(unit_tests); count ++)
@@ -0,0 +1,514 @@
+/*
+ * CBUtilLib test: Extra string functions
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* ISO library headers */
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <stdlib.h>
+
+/* CBUtilLib headers */
+#include "StrExtra.h"
+
+/* Local headers */
+#include "Tests.h"
+
+enum
+{
+  OutputBufferSize = 64,
+  Marker = 'X',
+  LargeInputSize = 1 << 20,
+};
+
+static const char srch[] = "<>&\"";
+static const char *rplc[] = { "&lt;", "&gt;", "&amp;", "&quot;" };
+
+static const struct
+{
+  const char *input;
+  const char *output;
+}
+inflate_cases[] =
+{
+  { "", "" },
+  { "plain text", "plain text" },
+  { "<", "&lt;" },
+  { "a<b", "a&lt;b" },
+  { "<tag attr=\"x&y\">", "&lt;tag attr=&quot;x&amp;y&quot;&gt;" },
+  { "&&&", "&amp;&amp;&amp;" },
+  { "trailing>", "trailing&gt;" },
+};
+
+static void test1(void)
+{
+  /* Inflate with sufficient space */
+  StrInflater inflater;
+  strinflater_init(&inflater, srch, rplc);
+
+  for (size_t i = 0; i < ARRAY_SIZE(inflate_cases); i++)
+  {
+    char s1[OutputBufferSize];
+    const size_t expected_len = strlen(inflate_cases[i].output);
+
+    size_t len = strinflater_inflate(&inflater, s1, sizeof(s1),
+                                     inflate_cases[i].input);
+    assert(len == expected_len);
+    assert(strcmp(s1, inflate_cases[i].output) == 0);
+
+    /* The precompiled inflater must agree with strinflate */
+    len = strinflate(s1, sizeof(s1), inflate_cases[i].input, srch, rplc);
+    assert(len == expected_len);
+    assert(strcmp(s1, inflate_cases[i].output) == 0);
+  }
+}
+
+static void test2(void)
+{
+  /* Inflate to measure */
+  StrInflater inflater;
+  strinflater_init(&inflater, srch, rplc);
+
+  for (size_t i = 0; i < ARRAY_SIZE(inflate_cases); i++)
+  {
+    const size_t len = strinflater_inflate(&inflater, NULL, 0,
+                                           inflate_cases[i].input);
+    assert(len == strlen(inflate_cases[i].output));
+  }
+}
+
+static void test3(void)
+{
+  /* Inflate with truncation */
+  StrInflater inflater;
+  strinflater_init(&inflater, srch, rplc);
+
+  for (size_t i = 0; i < ARRAY_SIZE(inflate_cases); i++)
+  {
+    const size_t expected_len = strlen(inflate_cases[i].output);
+
+    for (size_t n = 1; n <= expected_len + 1; n++)
+    {
+      char s1[OutputBufferSize];
+      memset(s1, Marker, sizeof(s1));
+
+      const size_t len = strinflater_inflate(&inflater, s1, n,
+                                             inflate_cases[i].input);
+      assert(len == expected_len);
+      assert(strlen(s1) == n - 1);
+      assert(strncmp(s1, inflate_cases[i].output, n - 1) == 0);
+      assert(s1[n] == Marker);
+    }
+  }
+}
+
+static void test4(void)
+{
+  /* Inflate with duplicate search characters */
+  static const char dup_srch[] = "aba";
+  static const char *dup_rplc[] = { "1", "2", "3" };
+  StrInflater inflater;
+  char s1[OutputBufferSize];
+
+  strinflater_init(&inflater, dup_srch, dup_rplc);
+  const size_t len = strinflater_inflate(&inflater, s1, sizeof(s1), "abc");
+  assert(len == 3);
+  assert(strcmp(s1, "12c") == 0);
+}
+
+static const char *entities[] = { "&lt;", "&gt;", "&amp;", "&quot;" };
+static const char *chars[] = { "<", ">", "&", "\"" };
+
+static void test5(void)
+{
+  /* Deflate */
+  StrDeflater *const deflater = strdeflater_make(ARRAY_SIZE(entities),
+                                                 entities, chars);
+  assert(deflater != NULL);
+
+  for (size_t i = 0; i < ARRAY_SIZE(inflate_cases); i++)
+  {
+    char s1[OutputBufferSize];
+    const size_t expected_len = strlen(inflate_cases[i].input);
+
+    const size_t len = strdeflate(deflater, s1, sizeof(s1),
+                                  inflate_cases[i].output);
+    assert(len == expected_len);
+    assert(strcmp(s1, inflate_cases[i].input) == 0);
+  }
+
+  /* Incomplete and unknown sequences are copied verbatim */
+  char s1[OutputBufferSize];
+  const size_t len = strdeflate(deflater, s1, sizeof(s1),
+                                "&am&amp;&foo;&lt&&gt;");
+  assert(len == strlen("&am&&foo;&lt&>"));
+  assert(strcmp(s1, "&am&&foo;&lt&>") == 0);
+
+  strdeflater_destroy(deflater);
+}
+
+static void test6(void)
+{
+  /* Deflate in place */
+  StrDeflater *const deflater = strdeflater_make(ARRAY_SIZE(entities),
+                                                 entities, chars);
+  assert(deflater != NULL);
+
+  for (size_t i = 0; i < ARRAY_SIZE(inflate_cases); i++)
+  {
+    char s1[OutputBufferSize];
+    strcpy(s1, inflate_cases[i].output);
+
+    const size_t len = strdeflate(deflater, s1, sizeof(s1), s1);
+    assert(len == strlen(inflate_cases[i].input));
+    assert(strcmp(s1, inflate_cases[i].input) == 0);
+  }
+
+  strdeflater_destroy(deflater);
+}
+
+static void test7(void)
+{
+  /* Deflate with truncation */
+  StrDeflater *const deflater = strdeflater_make(ARRAY_SIZE(entities),
+                                                 entities, chars);
+  assert(deflater != NULL);
+
+  for (size_t i = 0; i < ARRAY_SIZE(inflate_cases); i++)
+  {
+    const size_t expected_len = strlen(inflate_cases[i].input);
+
+    assert(strdeflate(deflater, NULL, 0, inflate_cases[i].output) ==
+           expected_len);
+
+    for (size_t n = 1; n <= expected_len + 1; n++)
+    {
+      char s1[OutputBufferSize];
+      memset(s1, Marker, sizeof(s1));
+
+      const size_t len = strdeflate(deflater, s1, n,
+                                    inflate_cases[i].output);
+      assert(len == expected_len);
+      assert(strlen(s1) == n - 1);
+      assert(strncmp(s1, inflate_cases[i].input, n - 1) == 0);
+      assert(s1[n] == Marker);
+    }
+  }
+
+  strdeflater_destroy(deflater);
+}
+
+static void test8(void)
+{
+  /* Deflate overlapping search strings */
+  static const char *srch[] = { "abcd", "bc", "c", "xyz", "yz", "bc" };
+  static const char *rplc[] = { "1", "2", "3", "4", "5", "6" };
+  static const struct
+  {
+    const char *input;
+    const char *output;
+  }
+  cases[] =
+  {
+    { "abcd", "a2d" },   /* "bc" ends before "abcd" */
+    { "ac", "a3" },
+    { "xyz", "4" },      /* longest of the strings ending at 'z' */
+    { "yzxyz", "54" },
+    { "bcbc", "22" },    /* only the first duplicate is used */
+    { "abxyzc", "ab43" },
+  };
+
+  StrDeflater *const deflater = strdeflater_make(ARRAY_SIZE(srch),
+                                                 srch, rplc);
+  assert(deflater != NULL);
+
+  for (size_t i = 0; i < ARRAY_SIZE(cases); i++)
+  {
+    char s1[OutputBufferSize];
+    const size_t len = strdeflate(deflater, s1, sizeof(s1), cases[i].input);
+    assert(len == strlen(cases[i].output));
+    assert(strcmp(s1, cases[i].output) == 0);
+  }
+
+  strdeflater_destroy(deflater);
+}
+
+static void test9(void)
+{
+  /* Deflate with no search strings */
+  StrDeflater *const deflater = strdeflater_make(0, NULL, NULL);
+  assert(deflater != NULL);
+
+  char s1[OutputBufferSize];
+  const size_t len = strdeflate(deflater, s1, sizeof(s1), "unchanged");
+  assert(len == strlen("unchanged"));
+  assert(strcmp(s1, "unchanged") == 0);
+
+  strdeflater_destroy(deflater);
+}
+
+static void test10(void)
+{
+  /* Inflate and deflate large string */
+  char *const input = malloc(LargeInputSize + 1);
+  assert(input != NULL);
+
+  static const char alphabet[] = "<a&b>c\"d e";
+  for (size_t i = 0; i < LargeInputSize; i++)
+  {
+    input[i] = alphabet[(i * 7) % (sizeof(alphabet) - 1)];
+  }
+  input[LargeInputSize] = '\0';
+
+  StrInflater inflater;
+  strinflater_init(&inflater, srch, rplc);
+
+  const size_t inflated_len = strinflater_inflate(&inflater, NULL, 0, input);
+  assert(inflated_len > LargeInputSize);
+
+  char *const inflated = malloc(inflated_len + 1);
+  assert(inflated != NULL);
+  size_t len = strinflater_inflate(&inflater, inflated, inflated_len + 1,
+                                   input);
+  assert(len == inflated_len);
+
+  StrDeflater *const deflater = strdeflater_make(ARRAY_SIZE(entities),
+                                                 entities, chars);
+  assert(deflater != NULL);
+
+  len = strdeflate(deflater, inflated, inflated_len + 1, inflated);
+  assert(len == LargeInputSize);
+  assert(strcmp(inflated, input) == 0);
+
+  strdeflater_destroy(deflater);
+  free(inflated);
+  free(input);
+}
+
+static void test11(void)
+{
+  /* Tail */
+  static const struct
+  {
+    const char *s;
+    size_t n;
+    size_t offset;
+  }
+  cases[] =
+  {
+    { "", 1, 0 },
+    { "file", 1, 0 },
+    { "dir.file", 1, 4 },
+    { "a.b.c.d", 1, 6 },
+    { "a.b.c.d", 2, 4 },
+    { "a.b.c.d", 3, 2 },
+    { "a.b.c.d", 4, 0 },
+    { "a.b.c.d", 5, 0 },
+    { ".leading", 1, 1 },
+    { "trailing.", 1, 9 },
+    { "ADFS::HardDisc4.$.Documents.Letters.Very.Deep.Path.Name", 3, 41 },
+    { "ADFS::HardDisc4.$.Documents.Letters.Very.Deep.Path.Name", 9, 0 },
+  };
+
+  for (size_t i = 0; i < ARRAY_SIZE(cases); i++)
+  {
+    const size_t len = strlen(cases[i].s);
+    const char *const expected = cases[i].s + cases[i].offset;
+
+    assert(strtail(cases[i].s, '.', cases[i].n) == expected);
+    assert(strtail_n(cases[i].s, len, '.', cases[i].n) == expected);
+  }
+
+  /* No separators are needed to find no elements */
+  assert(strtail("a.b", '.', 0) == strchr("a.b", '\0'));
+}
+
+static void test12(void)
+{
+  /* Tail of unterminated string */
+  static const char s[] = "one.two.three.four.five.six.seven.eight";
+
+  for (size_t len = 0; len < sizeof(s); len++)
+  {
+    char *const copy = malloc(len ? len : 1);
+    assert(copy != NULL);
+    memcpy(copy, s, len);
+
+    /* The expected result is found by a plain backward scan */
+    for (size_t n = 1; n < 10; n++)
+    {
+      size_t offset = len, count = 0;
+      while (offset > 0 && count < n)
+      {
+        if (s[--offset] == '.')
+          ++count;
+      }
+      const size_t expected = count >= n ? offset + 1 : 0;
+      assert(strtail_n(copy, len, '.', n) == copy + expected);
+    }
+
+    free(copy);
+  }
+}
+
+static void test13(void)
+{
+  /* Tail of many strings */
+  static const char *const s[] = { "a.b.c", "", "abc", "x.y" };
+  static const size_t len[] = { 5, 0, 3, 1 };
+  char *tails[ARRAY_SIZE(s)];
+
+  strtail_many(tails, s, NULL, ARRAY_SIZE(s), '.', 2);
+  assert(tails[0] == s[0] + 2);
+  assert(tails[1] == s[1]);
+  assert(tails[2] == s[2]);
+  assert(tails[3] == s[3]);
+
+  strtail_many(tails, s, len, ARRAY_SIZE(s), '.', 1);
+  assert(tails[0] == s[0] + 4);
+  assert(tails[1] == s[1]);
+  assert(tails[2] == s[2]);
+  assert(tails[3] == s[3]);
+}
+
+static void test14(void)
+{
+  /* Duplicate many strings */
+  static const char *const s[] = { "first", "", NULL, "fourth string" };
+  char **const copies = strdup_many(ARRAY_SIZE(s), s);
+  assert(copies != NULL);
+
+  for (size_t i = 0; i < ARRAY_SIZE(s); i++)
+  {
+    if (s[i] == NULL)
+    {
+      assert(copies[i] == NULL);
+    }
+    else
+    {
+      assert(copies[i] != s[i]);
+      assert(strcmp(copies[i], s[i]) == 0);
+    }
+  }
+
+  /* The copies are modifiable */
+  copies[0][0] = 'F';
+  assert(strcmp(copies[0], "First") == 0);
+  assert(strcmp(copies[1], "") == 0);
+
+  free(copies);
+}
+
+static void test15(void)
+{
+  /* Duplicate no strings */
+  char **const copies = strdup_many(0, NULL);
+  assert(copies != NULL);
+  free(copies);
+}
+
+static void test16(void)
+{
+#ifdef FORTIFY
+  /* Duplicate many strings fail */
+  static const char *const s[] = { "foo", "bar" };
+
+  Fortify_SetNumAllocationsLimit(0);
+  char **const copies = strdup_many(ARRAY_SIZE(s), s);
+  Fortify_SetNumAllocationsLimit(ULONG_MAX);
+  assert(copies == NULL);
+#endif
+}
+
+static void test17(void)
+{
+  /* Deflate after the arrays used to make the deflater are reused */
+  const char *srch[ARRAY_SIZE(entities)], *rplc[ARRAY_SIZE(chars)];
+  char srch_copy[ARRAY_SIZE(entities)][sizeof("&quot;")];
+
+  for (size_t i = 0; i < ARRAY_SIZE(entities); i++)
+  {
+    assert(strlen(entities[i]) < sizeof(srch_copy[i]));
+    strcpy(srch_copy[i], entities[i]);
+    srch[i] = srch_copy[i];
+    rplc[i] = chars[i];
+  }
+
+  StrDeflater *const deflater = strdeflater_make(ARRAY_SIZE(srch),
+                                                 srch, rplc);
+  assert(deflater != NULL);
+
+  for (size_t i = 0; i < ARRAY_SIZE(entities); i++)
+  {
+    srch[i] = NULL;
+    rplc[i] = NULL;
+    memset(srch_copy[i], 0, sizeof(srch_copy[i]));
+  }
+
+  char s1[OutputBufferSize];
+  const size_t len = strdeflate(deflater, s1, sizeof(s1), "&lt;a&amp;b&gt;");
+  assert(len == strlen("<a&b>"));
+  assert(strcmp(s1, "<a&b>") == 0);
+
+  strdeflater_destroy(deflater);
+}
+
+void StrExtra_tests(void)
+{
+  static const struct
+  {
+    const char *test_name;
+    void (*test_func)(void);
+  }
+  unit_tests[] =
+  {
+    { "Inflate", test1 },
+    { "Inflate to measure", test2 },
+    { "Inflate with truncation", test3 },
+    { "Inflate with duplicate search characters", test4 },
+    { "Deflate", test5 },
+    { "Deflate in place", test6 },
+    { "Deflate with truncation", test7 },
+    { "Deflate overlapping search strings", test8 },
+    { "Deflate with no search strings", test9 },
+    { "Inflate and deflate large string", test10 },
+    { "Tail", test11 },
+    { "Tail of unterminated string", test12 },
+    { "Tail of many strings", test13 },
+    { "Duplicate many strings", test14 },
+    { "Duplicate no strings", test15 },
+    { "Duplicate many strings fail", test16 },
+    { "Deflate after reusing arrays", test17 },
+  };
+
+  for (size_t count = 0; count < ARRAY_SIZE(unit_tests); count ++)
+  {
+    printf("Test %zu/%zu : %s\n",
+           1 + count,
+           ARRAY_SIZE(unit_tests),
+           unit_tests[count].test_name);
+
+    Fortify_EnterScope();
+
+    unit_tests[count].test_func();
+
+    Fortify_LeaveScope();
+  }
+}
@@ -60,5 +60,12 @@ void StringBuffer_tests(void);
 void FileRWInt_tests(void);
 void strdict_tests(void);
 void intdict_tests(void);
+void SortedDict_tests(void);
+void StrExtra_tests(void);
+void CSV_tests(void);
+void TrigTable_tests(void);
+void ArgUtils_tests(void);
+void ThreadPool_tests(void);
+void ByteRing_tests(void);
 
 #endif /* Tests_h */
@@ -0,0 +1,169 @@
+/*
+ * CBUtilLib benchmark: Trigonometric look-up tables
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* Compares the time taken to look up sines (and sines with cosines) using
+   a table whose quarter turn is a power of two, the same table with its
+   mask cleared to force the general path, and a table for a full turn.
+   Angles are either consecutive or random (which defeats branch
+   prediction in the general path). This program is not run as part of
+   the unit tests. */
+
+/* ISO library headers */
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* CBUtilLib headers */
+#include "TrigTable.h"
+
+enum
+{
+  Multiplier = 4096,
+  QuarterTurn = 1024,
+  NumberOfAngles = 1 << 20,
+  Repeats = 5,
+};
+
+static int angles[NumberOfAngles];
+
+static double get_time(void)
+{
+  struct timespec ts;
+  if (!timespec_get(&ts, TIME_UTC))
+  {
+    return (double)clock() / CLOCKS_PER_SEC;
+  }
+  return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+static void make_angles(bool const random)
+{
+  /* Angles span several turns in both directions */
+  int const range = QuarterTurn * 4 * 8;
+  for (int i = 0; i < NumberOfAngles; ++i)
+  {
+    angles[i] = random ? (rand() % range) - (range / 2) :
+                         (i % range) - (range / 2);
+  }
+}
+
+static double time_sine(const TrigTable *const table, long long *const sum)
+{
+  double const start = get_time();
+  for (int i = 0; i < NumberOfAngles; ++i)
+  {
+    *sum += TrigTable_look_up_sine(table, angles[i]);
+  }
+  return get_time() - start;
+}
+
+static double time_sincos(const TrigTable *const table, long long *const sum)
+{
+  double const start = get_time();
+  for (int i = 0; i < NumberOfAngles; ++i)
+  {
+    int sine, cosine;
+    TrigTable_look_up_sincos(table, angles[i], &sine, &cosine);
+    *sum += sine + cosine;
+  }
+  return get_time() - start;
+}
+
+static double best_of(const TrigTable *const table,
+                      double (*const fn)(const TrigTable *, long long *),
+                      long long *const sum)
+{
+  /* Returns the time per look-up in nanoseconds */
+  double best = 0;
+  for (int i = 0; i < Repeats; ++i)
+  {
+    double const t = fn(table, sum);
+    if (i == 0 || t < best)
+    {
+      best = t;
+    }
+  }
+  return best * 1e9 / NumberOfAngles;
+}
+
+int main(void)
+{
+  TrigTable *const pow2 = TrigTable_make(Multiplier, QuarterTurn);
+  TrigTable *const full = TrigTable_make_full(Multiplier, QuarterTurn);
+  if (pow2 == NULL || full == NULL)
+  {
+    fputs("Failed to make tables\n", stderr);
+    TrigTable_destroy(full);
+    TrigTable_destroy(pow2);
+    return EXIT_FAILURE;
+  }
+
+  /* Same values, but look-up can't mask the angle */
+  TrigTable general = *pow2;
+  general.mask = 0;
+  general.shift = 0;
+
+  static const struct
+  {
+    const char *name;
+    bool random;
+  }
+  orders[] =
+  {
+    { "consecutive", false },
+    { "random", true },
+  };
+
+  const struct
+  {
+    const char *name;
+    const TrigTable *table;
+  }
+  paths[] =
+  {
+    { "general", &general },
+    { "power of two", pow2 },
+    { "full turn", full },
+  };
+
+  printf("%-12s %-14s %12s %12s\n", "angles", "path", "sine (ns)",
+         "sincos (ns)");
+
+  long long sum = 0;
+  for (size_t o = 0; o < sizeof(orders) / sizeof(orders[0]); ++o)
+  {
+    make_angles(orders[o].random);
+
+    for (size_t p = 0; p < sizeof(paths) / sizeof(paths[0]); ++p)
+    {
+      double const sine_time = best_of(paths[p].table, time_sine, &sum);
+      double const sincos_time = best_of(paths[p].table, time_sincos, &sum);
+      printf("%-12s %-14s %12.2f %12.2f\n", orders[o].name, paths[p].name,
+             sine_time, sincos_time);
+    }
+  }
+
+  /* The sum is printed to stop the work being optimized away */
+  fprintf(stderr, "%lld\n", sum);
+
+  TrigTable_destroy(full);
+  TrigTable_destroy(pow2);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,94 @@
+/*
+ * CBUtilLib: Generate source code for constant trigonometric tables
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* Writes C source code defining constant trigonometric tables for the
+   most commonly used multipliers and quarter turns to the file named by
+   the first command-line argument. The makefile runs this program to
+   generate a source file which is compiled into the unit tests. */
+
+/* ISO library headers */
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* CBUtilLib headers */
+#include "TrigTable.h"
+
+static const struct
+{
+  const char *name;
+  int         multiplier;
+  int         quarter_turn;
+  bool        full;
+}
+tables[] =
+{
+  { "TrigTable_4096_1024", 4096, 1024, false },
+  { "TrigTable_4096_4096", 4096, 4096, false },
+  { "TrigTable_4096_1024_full", 4096, 1024, true },
+};
+
+static bool write_table(FILE *const f, size_t const i)
+{
+  TrigTable *const table = tables[i].full ?
+      TrigTable_make_full(tables[i].multiplier, tables[i].quarter_turn) :
+      TrigTable_make(tables[i].multiplier, tables[i].quarter_turn);
+
+  if (table == NULL)
+  {
+    fprintf(stderr, "Failed to make table %s\n", tables[i].name);
+    return false;
+  }
+
+  bool const success = TrigTable_write_source(table, f, tables[i].name) &&
+                       fputc('\n', f) != EOF;
+  TrigTable_destroy(table);
+  return success;
+}
+
+int main(int argc, char *argv[])
+{
+  if (argc != 2)
+  {
+    fputs("Usage: TrigGen <output file>\n", stderr);
+    return EXIT_FAILURE;
+  }
+
+  FILE *const f = fopen(argv[1], "w");
+  if (f == NULL)
+  {
+    fprintf(stderr, "Failed to open %s\n", argv[1]);
+    return EXIT_FAILURE;
+  }
+
+  bool success = true;
+  for (size_t i = 0; success && i < sizeof(tables) / sizeof(tables[0]); ++i)
+  {
+    success = write_table(f, i);
+  }
+
+  if (fclose(f) != 0 || !success)
+  {
+    fprintf(stderr, "Failed to write %s\n", argv[1]);
+    remove(argv[1]);
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
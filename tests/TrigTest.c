@@ -0,0 +1,622 @@
+/*
+ * CBUtilLib test: Trigonometric look-up tables
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* ISO library headers */
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <stdint.h>
+#include <math.h>
+#include <string.h>
+
+/* CBUtilLib headers */
+#include "TrigTable.h"
+
+/* Local headers */
+#include "Tests.h"
+
+enum
+{
+  Multiplier = 4096,
+  QuarterTurn = 1024,
+  FullTurn = QuarterTurn * 4,
+  NumVectors = 1000,
+};
+
+static double to_radians(int const angle)
+{
+  return (angle * 2.0 * atan(1.0)) / QuarterTurn;
+}
+
+static int from_radians(double const radians)
+{
+  return (int)floor((radians * QuarterTurn) / (2.0 * atan(1.0)) + 0.5);
+}
+
+static int scale(double const value)
+{
+  return (int)floor(value * Multiplier + 0.5);
+}
+
+static bool angles_near(int const a, int const b, int const tolerance)
+{
+  /* Allow for the same angle being expressed in different turns */
+  int diff = abs(a - b) % FullTurn;
+  if (diff > FullTurn / 2)
+  {
+    diff = FullTurn - diff;
+  }
+  return diff <= tolerance;
+}
+
+static void test1(void)
+{
+  /* Look up sine and cosine */
+  TrigTable *const table = TrigTable_make(Multiplier, QuarterTurn);
+  assert(table != NULL);
+
+  for (int angle = -FullTurn * 2; angle <= FullTurn * 2; angle++)
+  {
+    assert(TrigTable_look_up_sine(table, angle) ==
+           scale(sin(to_radians(angle))));
+    assert(abs(TrigTable_look_up_cosine(table, angle) -
+               scale(cos(to_radians(angle)))) <= 1);
+  }
+
+  TrigTable_destroy(table);
+}
+
+static void test2(void)
+{
+  /* Look up inverse sine and cosine */
+  TrigTable *const table = TrigTable_make(Multiplier, QuarterTurn);
+  assert(table != NULL);
+
+  for (int value = -Multiplier - 10; value <= Multiplier + 10; value++)
+  {
+    int const asin_angle = TrigTable_look_up_asin(table, value);
+    int const acos_angle = TrigTable_look_up_acos(table, value);
+
+    assert(asin_angle >= -QuarterTurn && asin_angle <= QuarterTurn);
+    assert(acos_angle >= 0 && acos_angle <= QuarterTurn * 2);
+    assert(asin_angle + acos_angle == QuarterTurn);
+
+    /* No other angle has a sine nearer to the given value */
+    int const clamped = value < -Multiplier ? -Multiplier :
+                        value > Multiplier ? Multiplier : value;
+    int const error = abs(TrigTable_look_up_sine(table, asin_angle) -
+                          clamped);
+    if (asin_angle > -QuarterTurn)
+    {
+      assert(abs(TrigTable_look_up_sine(table, asin_angle - 1) - clamped) >=
+             error);
+    }
+    if (asin_angle < QuarterTurn)
+    {
+      assert(abs(TrigTable_look_up_sine(table, asin_angle + 1) - clamped) >=
+             error);
+    }
+
+    /* Away from the peaks, the result should agree with the C library */
+    if (abs(value) < Multiplier * 9 / 10)
+    {
+      double const ratio = (double)value / Multiplier;
+      assert(angles_near(asin_angle, from_radians(asin(ratio)), 1));
+      assert(angles_near(acos_angle, from_radians(acos(ratio)), 1));
+    }
+  }
+
+  assert(TrigTable_look_up_asin(table, Multiplier) == QuarterTurn);
+  assert(TrigTable_look_up_asin(table, INT_MIN) == -QuarterTurn);
+  assert(TrigTable_look_up_acos(table, -Multiplier) == QuarterTurn * 2);
+  assert(TrigTable_look_up_acos(table, INT_MAX) == 0);
+
+  TrigTable_destroy(table);
+}
+
+static void test3(void)
+{
+  /* Look up inverse tangent */
+  TrigTable *const table = TrigTable_make(Multiplier, QuarterTurn);
+  assert(table != NULL);
+
+  /* Every angle around the circle, at different radii */
+  static const int radii[] = { 100, 10000, INT_MAX / 2 };
+  for (size_t r = 0; r < ARRAY_SIZE(radii); r++)
+  {
+    for (int angle = -QuarterTurn * 2 + 1; angle <= QuarterTurn * 2; angle++)
+    {
+      int const x = (int)floor(cos(to_radians(angle)) * radii[r] + 0.5);
+      int const y = (int)floor(sin(to_radians(angle)) * radii[r] + 0.5);
+      int const result = TrigTable_look_up_atan2(table, y, x);
+
+      assert(result > -QuarterTurn * 2 && result <= QuarterTurn * 2);
+      assert(angles_near(result, angle, radii[r] >= 10000 ? 1 : 8));
+    }
+  }
+
+  /* Special cases */
+  assert(TrigTable_look_up_atan2(table, 0, 0) == 0);
+  assert(TrigTable_look_up_atan2(table, 0, 1) == 0);
+  assert(TrigTable_look_up_atan2(table, 1, 0) == QuarterTurn);
+  assert(TrigTable_look_up_atan2(table, 0, -1) == QuarterTurn * 2);
+  assert(TrigTable_look_up_atan2(table, -1, 0) == -QuarterTurn);
+  assert(TrigTable_look_up_atan2(table, INT_MIN, INT_MIN) ==
+         -QuarterTurn * 3 / 2);
+  assert(TrigTable_look_up_atan2(table, INT_MAX, INT_MIN) ==
+         QuarterTurn * 3 / 2);
+
+  /* Random vectors should agree with the C library */
+  srand(3);
+  for (int i = 0; i < NumVectors; i++)
+  {
+    int const x = rand() - RAND_MAX / 2, y = rand() - RAND_MAX / 2;
+    assert(angles_near(TrigTable_look_up_atan2(table, y, x),
+                       from_radians(atan2(y, x)), 1));
+  }
+
+  TrigTable_destroy(table);
+}
+
+static void test4(void)
+{
+  /* Look up inverse functions in batches */
+  TrigTable *const table = TrigTable_make(Multiplier, QuarterTurn);
+  assert(table != NULL);
+
+  static int values[NumVectors], x[NumVectors], angles[NumVectors];
+  srand(4);
+  for (size_t i = 0; i < NumVectors; i++)
+  {
+    values[i] = rand() % (Multiplier * 2 + 1) - Multiplier;
+    x[i] = rand() - RAND_MAX / 2;
+  }
+
+  TrigTable_look_up_asin_many(table, angles, values, NumVectors);
+  for (size_t i = 0; i < NumVectors; i++)
+  {
+    assert(angles[i] == TrigTable_look_up_asin(table, values[i]));
+  }
+
+  TrigTable_look_up_acos_many(table, angles, values, NumVectors);
+  for (size_t i = 0; i < NumVectors; i++)
+  {
+    assert(angles[i] == TrigTable_look_up_acos(table, values[i]));
+  }
+
+  TrigTable_look_up_atan2_many(table, angles, values, x, NumVectors);
+  for (size_t i = 0; i < NumVectors; i++)
+  {
+    assert(angles[i] == TrigTable_look_up_atan2(table, values[i], x[i]));
+  }
+
+  TrigTable_destroy(table);
+}
+
+/* Defined in source code generated by TrigGen at build time */
+extern const TrigTable TrigTable_4096_1024, TrigTable_4096_4096,
+                       TrigTable_4096_1024_full;
+
+/* Output of TrigTable_write_source for a small table */
+static const int SmallTable_sine_values[3] =
+{
+  0, 71, 100,
+};
+
+static const TrigTable SmallTable =
+{
+  .multiplier = 100,
+  .quarter_turn = 2,
+  .sine_values = SmallTable_sine_values,
+  .mask = 0x7,
+  .shift = 1,
+};
+
+static void test5(void)
+{
+  /* Write a table as source code */
+  TrigTable *const table = TrigTable_make(100, 2);
+  assert(table != NULL);
+
+  FILE *const f = tmpfile();
+  assert(f != NULL);
+
+  bool success = TrigTable_write_source(table, f, "SmallTable");
+  assert(success);
+
+  static const char expected[] =
+    "/* Trigonometric table with multiplier 100 and quarter turn 2 */\n"
+    "#include \"TrigTable.h\"\n\n"
+    "static const int SmallTable_sine_values[3] =\n{\n"
+    "  0, 71, 100,\n"
+    "};\n\n"
+    "const TrigTable SmallTable =\n{\n"
+    "  .multiplier = 100,\n"
+    "  .quarter_turn = 2,\n"
+    "  .sine_values = SmallTable_sine_values,\n"
+    "  .mask = 0x7,\n"
+    "  .shift = 1,\n"
+    "};\n";
+
+  char buf[sizeof(expected) + 1];
+  rewind(f);
+  size_t const n = fread(buf, 1, sizeof(buf), f);
+  assert(n == sizeof(expected) - 1);
+  assert(memcmp(buf, expected, n) == 0);
+
+  fclose(f);
+  TrigTable_destroy(table);
+
+  assert(TrigTable_look_up_sine(&SmallTable, 1) == 71);
+  assert(TrigTable_look_up_cosine(&SmallTable, 1) == 71);
+  assert(TrigTable_look_up_sine(&SmallTable, -2) == -100);
+  assert(TrigTable_look_up_asin(&SmallTable, 70) == 1);
+}
+
+static void test6(void)
+{
+  /* Use a statically-defined table */
+  TrigTable *const table = TrigTable_make(Multiplier, QuarterTurn);
+  assert(table != NULL);
+
+  FILE *const f = tmpfile();
+  assert(f != NULL);
+  bool success = TrigTable_write_source(table, f, "Table");
+  assert(success);
+
+  /* Read back the values written and use them to define a table */
+  static int values[QuarterTurn + 1];
+  rewind(f);
+  int c;
+  while ((c = fgetc(f)) != EOF && c != '{')
+  {
+  }
+  for (int i = 0; i <= QuarterTurn; i++)
+  {
+    int const nread = fscanf(f, "%d,", &values[i]);
+    assert(nread == 1);
+  }
+  fclose(f);
+
+  const TrigTable static_table =
+  {
+    .multiplier = Multiplier,
+    .quarter_turn = QuarterTurn,
+    .sine_values = values,
+  };
+
+  for (int angle = -FullTurn; angle <= FullTurn; angle++)
+  {
+    assert(TrigTable_look_up_sine(&static_table, angle) ==
+           TrigTable_look_up_sine(table, angle));
+    assert(TrigTable_look_up_cosine(&static_table, angle) ==
+           TrigTable_look_up_cosine(table, angle));
+  }
+
+  TrigTable_destroy(table);
+}
+
+static void test7(void)
+{
+  /* Look up sine and cosine together */
+  TrigTable *const table = TrigTable_make(Multiplier, QuarterTurn);
+  assert(table != NULL);
+
+  for (int angle = -FullTurn * 2; angle <= FullTurn * 2; angle++)
+  {
+    int sine, cosine;
+    TrigTable_look_up_sincos(table, angle, &sine, &cosine);
+    assert(sine == TrigTable_look_up_sine(table, angle));
+    assert(cosine == TrigTable_look_up_cosine(table, angle));
+  }
+
+  int sine, cosine;
+  TrigTable_look_up_sincos(table, INT_MIN, &sine, &cosine);
+  assert(sine == TrigTable_look_up_sine(table, INT_MIN));
+  assert(cosine == TrigTable_look_up_cosine(table, INT_MIN));
+
+  TrigTable_destroy(table);
+}
+
+static void test8(void)
+{
+  /* Rotate points */
+  TrigTable *const table = TrigTable_make(Multiplier, QuarterTurn);
+  assert(table != NULL);
+
+  static const int square[] = { 100, 0, 0, 100, -100, 0, 0, -100, 70, -30 };
+  int rotated[ARRAY_SIZE(square)];
+
+  /* Quarter turns are exact */
+  TrigTable_rotate_points(table, QuarterTurn, square, rotated,
+                          ARRAY_SIZE(square) / 2);
+  static const int expected[] = { 0, 100, -100, 0, 0, -100, 100, 0, 30, 70 };
+  for (size_t i = 0; i < ARRAY_SIZE(square); i++)
+  {
+    assert(rotated[i] == expected[i]);
+  }
+
+  /* Other angles agree with the C library */
+  for (int angle = -FullTurn; angle <= FullTurn; angle += 7)
+  {
+    TrigTable_rotate_points(table, angle, square, rotated,
+                            ARRAY_SIZE(square) / 2);
+    const double c = cos(to_radians(angle)), s = sin(to_radians(angle));
+    for (size_t i = 0; i < ARRAY_SIZE(square); i += 2)
+    {
+      const double x = square[i] * c - square[i + 1] * s,
+                   y = square[i] * s + square[i + 1] * c;
+      assert(fabs(rotated[i] - x) <= 1.0);
+      assert(fabs(rotated[i + 1] - y) <= 1.0);
+    }
+  }
+
+  /* Rotate in place and back again */
+  static int points[NumVectors * 2];
+  static int copy[NumVectors * 2];
+  srand(8);
+  for (size_t i = 0; i < ARRAY_SIZE(points); i++)
+  {
+    points[i] = copy[i] = rand() % 2000001 - 1000000;
+  }
+  TrigTable_rotate_points(table, 300, points, points, NumVectors);
+  TrigTable_rotate_points(table, -300, points, points, NumVectors);
+  for (size_t i = 0; i < ARRAY_SIZE(points); i++)
+  {
+    assert(abs(points[i] - copy[i]) <= 1000000 / Multiplier + 2);
+  }
+
+  TrigTable_rotate_points(table, 0, NULL, NULL, 0);
+  TrigTable_destroy(table);
+}
+
+static void test9(void)
+{
+  /* Compare tables with and without a power-of-two quarter turn */
+  static const int quarter_turns[] = { 1, 2, 3, 64, 100, 1024 };
+
+  for (size_t q = 0; q < ARRAY_SIZE(quarter_turns); q++)
+  {
+    int const quarter_turn = quarter_turns[q];
+    TrigTable *const table = TrigTable_make(Multiplier, quarter_turn);
+    assert(table != NULL);
+
+    /* The general method of reduction is used for a copy of the table */
+    const TrigTable general =
+    {
+      .multiplier = table->multiplier,
+      .quarter_turn = table->quarter_turn,
+      .sine_values = table->sine_values,
+    };
+
+    for (int angle = -quarter_turn * 9; angle <= quarter_turn * 9; angle++)
+    {
+      assert(TrigTable_look_up_sine(table, angle) ==
+             TrigTable_look_up_sine(&general, angle));
+      assert(TrigTable_look_up_cosine(table, angle) ==
+             TrigTable_look_up_cosine(&general, angle));
+
+      int sine, cosine, general_sine, general_cosine;
+      TrigTable_look_up_sincos(table, angle, &sine, &cosine);
+      TrigTable_look_up_sincos(&general, angle, &general_sine,
+                               &general_cosine);
+      assert(sine == general_sine);
+      assert(cosine == general_cosine);
+    }
+
+    static const int extremes[] = { INT_MIN, INT_MIN + 1, INT_MAX - 1 };
+    for (size_t i = 0; i < ARRAY_SIZE(extremes); i++)
+    {
+      assert(TrigTable_look_up_sine(table, extremes[i]) ==
+             TrigTable_look_up_sine(&general, extremes[i]));
+    }
+
+    TrigTable_destroy(table);
+  }
+}
+
+static void test10(void)
+{
+  /* Compare tables for a full turn with tables for a quarter turn */
+  static const struct
+  {
+    int multiplier;
+    int quarter_turn;
+    bool is_short;
+  }
+  cases[] =
+  {
+    { Multiplier, QuarterTurn, true },
+    { Multiplier, 100, true },
+    { INT16_MAX, 64, true },
+    { INT16_MAX + 1, 64, false },
+    { 1 << 30, 1000, false },
+    { 1, 1, true },
+  };
+
+  for (size_t c = 0; c < ARRAY_SIZE(cases); c++)
+  {
+    int const quarter_turn = cases[c].quarter_turn;
+    TrigTable *const table = TrigTable_make(cases[c].multiplier,
+                                            quarter_turn);
+    assert(table != NULL);
+    TrigTable *const full = TrigTable_make_full(cases[c].multiplier,
+                                                quarter_turn);
+    assert(full != NULL);
+    assert((full->short_values != NULL) == cases[c].is_short);
+    assert((full->full_values != NULL) == !cases[c].is_short);
+
+    for (int angle = -quarter_turn * 9; angle <= quarter_turn * 9; angle++)
+    {
+      assert(TrigTable_look_up_sine(full, angle) ==
+             TrigTable_look_up_sine(table, angle));
+      assert(TrigTable_look_up_cosine(full, angle) ==
+             TrigTable_look_up_cosine(table, angle));
+
+      int sine, cosine;
+      TrigTable_look_up_sincos(full, angle, &sine, &cosine);
+      assert(sine == TrigTable_look_up_sine(table, angle));
+      assert(cosine == TrigTable_look_up_cosine(table, angle));
+    }
+
+    static const int extremes[] = { INT_MIN, INT_MIN + 1, INT_MAX };
+    for (size_t i = 0; i < ARRAY_SIZE(extremes); i++)
+    {
+      assert(TrigTable_look_up_sine(full, extremes[i]) ==
+             TrigTable_look_up_sine(table, extremes[i]));
+    }
+
+    /* Inverse functions use the first quadrant */
+    for (int value = -cases[c].multiplier; value <= cases[c].multiplier;
+         value += 1 + cases[c].multiplier / 1000)
+    {
+      assert(TrigTable_look_up_asin(full, value) ==
+             TrigTable_look_up_asin(table, value));
+      assert(TrigTable_look_up_atan2(full, value, 1000) ==
+             TrigTable_look_up_atan2(table, value, 1000));
+    }
+
+    TrigTable_destroy(full);
+    TrigTable_destroy(table);
+  }
+}
+
+static void test11(void)
+{
+  /* Write a table for a full turn as source code */
+  TrigTable *const table = TrigTable_make_full(100, 1);
+  assert(table != NULL);
+
+  FILE *const f = tmpfile();
+  assert(f != NULL);
+
+  bool success = TrigTable_write_source(table, f, "Full");
+  assert(success);
+
+  static const char expected[] =
+    "/* Trigonometric table with multiplier 100 and quarter turn 1 */\n"
+    "#include \"TrigTable.h\"\n\n"
+    "static const int Full_sine_values[2] =\n{\n"
+    "  0, 100,\n"
+    "};\n\n"
+    "static const int16_t Full_short_values[4] =\n{\n"
+    "  0, 100, 0, -100,\n"
+    "};\n\n"
+    "const TrigTable Full =\n{\n"
+    "  .multiplier = 100,\n"
+    "  .quarter_turn = 1,\n"
+    "  .sine_values = Full_sine_values,\n"
+    "  .mask = 0x3,\n"
+    "  .shift = 0,\n"
+    "  .short_values = Full_short_values,\n"
+    "};\n";
+
+  char buf[sizeof(expected) + 1];
+  rewind(f);
+  size_t const n = fread(buf, 1, sizeof(buf), f);
+  assert(n == sizeof(expected) - 1);
+  assert(memcmp(buf, expected, n) == 0);
+
+  fclose(f);
+  TrigTable_destroy(table);
+}
+
+static void test12(void)
+{
+  /* Use generated tables */
+  static const struct
+  {
+    const TrigTable *generated;
+    int multiplier;
+    int quarter_turn;
+  }
+  cases[] =
+  {
+    { &TrigTable_4096_1024, Multiplier, QuarterTurn },
+    { &TrigTable_4096_4096, Multiplier, QuarterTurn * 4 },
+    { &TrigTable_4096_1024_full, Multiplier, QuarterTurn },
+  };
+
+  for (size_t c = 0; c < ARRAY_SIZE(cases); c++)
+  {
+    const TrigTable *const generated = cases[c].generated;
+    int const quarter_turn = cases[c].quarter_turn;
+    TrigTable *const table = TrigTable_make(cases[c].multiplier,
+                                            quarter_turn);
+    assert(table != NULL);
+
+    for (int angle = -quarter_turn * 5; angle <= quarter_turn * 5; angle++)
+    {
+      assert(TrigTable_look_up_sine(generated, angle) ==
+             TrigTable_look_up_sine(table, angle));
+      assert(TrigTable_look_up_cosine(generated, angle) ==
+             TrigTable_look_up_cosine(table, angle));
+    }
+
+    for (int value = -cases[c].multiplier; value <= cases[c].multiplier;
+         value++)
+    {
+      assert(TrigTable_look_up_asin(generated, value) ==
+             TrigTable_look_up_asin(table, value));
+    }
+
+    TrigTable_destroy(table);
+  }
+
+  assert(TrigTable_4096_1024_full.short_values != NULL);
+}
+
+void TrigTable_tests(void)
+{
+  static const struct
+  {
+    const char *test_name;
+    void (*test_func)(void);
+  }
+  unit_tests[] =
+  {
+    { "Look up sine and cosine", test1 },
+    { "Look up inverse sine and cosine", test2 },
+    { "Look up inverse tangent", test3 },
+    { "Look up inverse functions in batches", test4 },
+    { "Write a table as source code", test5 },
+    { "Use a statically-defined table", test6 },
+    { "Look up sine and cosine together", test7 },
+    { "Rotate points", test8 },
+    { "Power-of-two quarter turn", test9 },
+    { "Full turn", test10 },
+    { "Write a full turn as source code", test11 },
+    { "Use generated tables", test12 },
+  };
+
+  for (size_t count = 0; count < ARRAY_SIZE(unit_tests); count ++)
+  {
+    printf("Test %zu/%zu : %s\n",
+           1 + count,
+           ARRAY_SIZE(unit_tests),
+           unit_tests[count].test_name);
+
+    Fortify_EnterScope();
+
+    unit_tests[count].test_func();
+
+    Fortify_LeaveScope();
+  }
+}